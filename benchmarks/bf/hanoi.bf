@@ -0,0 +1,68 @@
+Towers of Hanoi with 20 disks: one line per move
+the disks are counted in binary on the band and the head walks to the disk that moves
+
+>>>>>>>>>>>>>>[-]+>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+++++++++>>>>>>>>[-]+++<<<<<<<[-]+>>>>[-]++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>>>>>[-]+>>[-]+++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[
+-]++>>>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++>>>>>>>[-]+>>[-]+++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[-]+>>>>[-]++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++>>>>>>>[-]+>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+++>>>>>>>>[-]+++<<<<<<<[-]++>>>>[-]+++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>>>>>[-]+>>[-]+++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[-]
++>>>>[-]++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++>>>>>>>[-]+>>[-]+++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[-]++>>>>[-]+++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++>>>>>>>[-]+>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+++++++>>>>>>>>[-]+++<<<<<<<[-]+>>>>[-]++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>>>>>[-]+>>[-]+++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>>>>>>[-]+++<<<<
+<<<[-]++>>>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++>>>>>>>[-]+>>[-]+++++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[-]+>>>>[-]++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++>>>>>>>[-]+>>[-]+++++++++++++++++++++++++++++++++++++++++++++++
+++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[-]++>>>>[-]+++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>
+>>>>[-]+>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>
+>>>>>>[-]+++<<<<<<<[-]+>>>>[-]++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>>>>>[-]+>>[-]+++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[
+-]++>>>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++>>>>>>>[-]+>>[-]+++++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[-]+>>>>[-]++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++>>>>>>>[-]+>>[-]+++++++++++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[-]++>>>>[-]+++++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++>>>>>>>[-]+>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+++++++>>>>>>>>[-]+++<<<<<<<[-]+>>>>[-]++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>>>>>[-]+
+>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>>>>>>[-
+]+++<<<<<<<[-]++>>>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>>>>>[-]+>>[-]+++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[-]
++>>>>[-]++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++>>>>>>>[-]+>>[-]+++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[-]++>>>>[-]+++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++>>>>>>>[-]+>>[-]+++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[-]+>>>>[-]++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++>>>>>>>[-]+>>[-]+++++++++++++++++++++++++++++++++++++++++++++++
+++++++++++++++++++>>>>>>>>[-]+++<<<<<<<[-]++>>>>[-]+++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++>>>>>>>[-]+>>>>[-]+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<[-]+[>>>>>>>>>>>>[->>>>>>>>>>>>>>]+>>>>+<[>>>>[-]+<<<-]>[>>.>>>>>>[-]++++++++++
+++++++++++++++++++++++.[-]<<<<<<<<<<<.>[->>>>>>+<<<<<<]>>>>>>[<<<<<<+<+>>>>>>>>-
+>+<[>-]>[<<<<<<<<<--->>>>>>>>[-]+++>->]<<<-]>>>>[-]+++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++.[-]<<<<<<<<<<<.>>>>>>>>>>>[-]++++++++++.[-]<<<
+<<<<<->]<<<<<<[>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<]>>
+>>>>>>[<<<<<[-]>>>>>-]<<<<<]
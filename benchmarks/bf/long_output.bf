@@ -0,0 +1,24 @@
+About 5 MB of output: 51200 lines of 100 printable characters
+
+>>>[-]+++++++++++++++++++++++++++++++++>>>[-]+++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++<[-]++++++++++<<<<<[-
+]--------------------------------------------------------[>[-]++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++[>>>[-]<[->>>>>>>>>+<<<<<<<<+<]>>>>>>>>>[-<<<<<<<<
+<+>>>>>>>>>]<<<[-]<<<[->>>>>>+<<<+<<<]>>>>>>[-<<<<<<+>>>>>>]<<<<<<<<<<[-]+++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++[>>.+>>>>>->+<[>-]>[<<<<<<-----------------------------------------
+----------------------------------------------------->>>>>[-]+++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++>->]<
+<<<<<<<<-]>>>.<<+>>>->+<[>-]>[<<<<----------------------------------------------
+------------------------------------------------>>>[-]++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++>->]<<<<[-]<
+[->>>>>>>>>+<<<<<<<<+<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]<<<[-]<<<[->>>>>>+<<<+<<<]
+>>>>>>[-<<<<<<+>>>>>>]<<<<<<<<<<[-]+++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++++++++++[>>.+>>>>>->+<[>-]>[<<<<<
+<-------------------------------------------------------------------------------
+--------------->>>>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++>->]<<<<<<<<<-]>>>.<<+>>>->+<[>-]>[<<<<----
+--------------------------------------------------------------------------------
+---------->>>[-]++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++>->]<<<<<<<-]<-]
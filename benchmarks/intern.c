@@ -0,0 +1,137 @@
+/*
+Micro-benchmark of the identifiers record.
+Interns the identifiers of the given source files, or of a generated
+program, as the lexer would: a few distinct names, looked up over and over.
+Hashing alone is timed as well, to compare the hashes of hash.h.
+Usage: bench_intern [file...]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "identifiers_record.h"
+#include "hash.h"
+
+#define ROUNDS 20
+#define GENERATED_NAMES 20000
+#define GENERATED_TOKENS 2000000
+
+typedef struct Slice {
+        const char* source;
+        unsigned short length;
+} Slice;
+
+typedef struct Workload {
+        char* text;
+        size_t len;
+        Slice* slices;
+        size_t nb_slices, capacity;
+} Workload;
+
+static void add_slice(Workload *const w, const char* source, const size_t length) {
+        if (w->nb_slices == w->capacity) {
+                w->capacity = w->capacity ? 2*w->capacity : 1024;
+                w->slices = realloc(w->slices, w->capacity*sizeof(Slice));
+        }
+        w->slices[w->nb_slices++] = (Slice) {.source=source, .length=length};
+}
+
+static int is_start(const char c) {
+        return c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+static int is_part(const char c) {
+        return is_start(c) || (c >= '0' && c <= '9');
+}
+
+static void append_text(Workload *const w, const char* text, const size_t len) {
+        w->text = realloc(w->text, w->len + len);
+        memcpy(w->text + w->len, text, len);
+        w->len += len;
+}
+
+static int read_file(Workload *const w, const char* path) {
+        FILE *const file = fopen(path, "r");
+        if (file == NULL) return 0;
+        char buffer[1<<16];
+        for (size_t got; (got = fread(buffer, 1, sizeof(buffer), file)) > 0; ) append_text(w, buffer, got);
+        fclose(file);
+        append_text(w, "\n", 1);
+        return 1;
+}
+
+static void generate(Workload *const w) {
+        // names of various shapes, drawn with a skewed distribution: most tokens are a few hot names
+        char name[64];
+        srand(42);
+        for (size_t i=0; i<GENERATED_TOKENS; i++) {
+                const double u = (double) rand() / RAND_MAX;
+                const unsigned int rank = (unsigned int) (GENERATED_NAMES * u * u * u);
+                const int len = snprintf(name, sizeof(name), (rank % 3) ? "v%u " : "some_longer_name_%u ", rank);
+                append_text(w, name, len);
+        }
+}
+
+static void split(Workload *const w) {
+        // slices point into the text, that must not move any more
+        for (size_t i=0; i<w->len; ) {
+                if (!is_start(w->text[i])) {
+                        i++;
+                        continue;
+                }
+                const size_t start = i;
+                while (i < w->len && is_part(w->text[i])) i++;
+                add_slice(w, w->text + start, i - start);
+        }
+}
+
+static double now(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+int main(int argc, char* argv[]) {
+        Workload w = {0};
+        for (int i=1; i<argc; i++) {
+                if (!read_file(&w, argv[i])) {
+                        fprintf(stderr, "Can't read %s.\n", argv[i]);
+                        return EXIT_FAILURE;
+                }
+        }
+        if (argc == 1) generate(&w);
+        split(&w);
+
+        double best = 1e9, best_hash = 1e9;
+        size_t distinct = 0;
+        uintptr_t check = 0; // so that the lookups can't be optimized away
+        for (int round=0; round<ROUNDS; round++) {
+                IdentifiersRecord record;
+                double start = now();
+                mk_identifiers_record(&record);
+                for (size_t i=0; i<w.nb_slices; i++) {
+                        check += (uintptr_t) internalize(&record, w.slices[i].source, w.slices[i].length);
+                }
+                distinct = record.nb_entries;
+                del_identifiers_record(&record);
+                double elapsed = now() - start;
+                if (elapsed < best) best = elapsed;
+
+                start = now();
+                for (size_t i=0; i<w.nb_slices; i++) check += hash_stringn(w.slices[i].source, w.slices[i].length);
+                elapsed = now() - start;
+                if (elapsed < best_hash) best_hash = elapsed;
+        }
+
+        printf("%lu identifiers, %lu distinct: %.2f ns per identifier, hashing alone %.2f (%lx)\n",
+                w.nb_slices, distinct, 1e9*best/w.nb_slices, 1e9*best_hash/w.nb_slices, (unsigned long) ((check >> 4) & 0xFFFF));
+
+        free(w.slices);
+        free(w.text);
+        return EXIT_SUCCESS;
+}
+
+#undef ROUNDS
+#undef GENERATED_NAMES
+#undef GENERATED_TOKENS
@@ -0,0 +1,96 @@
+/*
+Runs a command, its output thrown away, and prints its wall time in seconds,
+its peak RSS in kB and the instructions it executed in user space (-1 when
+the hardware counters can't be read).
+`doit bench` measures through this rather than from Python: a process forked
+by Python would start with the RSS of Python as its peak.
+Usage: bench_measure command [args...]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <linux/perf_event.h>
+
+static int open_counter(const pid_t pid) {
+        // counts from the exec on, in the command and the processes it forks
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled = 1;
+        attr.enable_on_exec = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return syscall(SYS_perf_event_open, &attr, pid, -1, -1, 0);
+}
+
+static double seconds(const struct timespec t) {
+        return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+int main(int argc, char* argv[]) {
+        if (argc < 2) {
+                fputs("Usage: bench_measure command [args...]\n", stderr);
+                return EXIT_FAILURE;
+        }
+
+        int go[2]; // the command waits for its counter before it starts
+        if (pipe(go)) {
+                perror("pipe");
+                return EXIT_FAILURE;
+        }
+
+        const pid_t pid = fork();
+        if (pid < 0) {
+                perror("fork");
+                return EXIT_FAILURE;
+        }
+        if (pid == 0) {
+                char c;
+                close(go[1]);
+                if (read(go[0], &c, 1) != 1) _exit(127);
+                close(go[0]);
+                const int null = open("/dev/null", O_WRONLY);
+                dup2(null, STDOUT_FILENO);
+                close(null);
+                execvp(argv[1], argv+1);
+                perror(argv[1]);
+                _exit(127);
+        }
+
+        close(go[0]);
+        const int counter = open_counter(pid);
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (write(go[1], "", 1) != 1) perror("write");
+        close(go[1]);
+
+        int status;
+        struct rusage usage;
+        wait4(pid, &status, 0, &usage);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        long long instructions = -1;
+        if (counter >= 0) {
+                uint64_t count;
+                if (read(counter, &count, sizeof(count)) == sizeof(count)) instructions = count;
+                close(counter);
+        }
+
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+                fprintf(stderr, "%s failed (status %d).\n", argv[1], status);
+                return EXIT_FAILURE;
+        }
+        printf("%.6f %ld %lld\n", seconds(end) - seconds(start), usage.ru_maxrss, instructions);
+        return EXIT_SUCCESS;
+}
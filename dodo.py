@@ -1,6 +1,10 @@
 #!/usr/bin/env -S doit -f
 
 from pathlib import Path
+import json
+import os
+import statistics
+import subprocess
 
 """
 Project directory structure :
@@ -127,6 +131,12 @@ _GCC_COMPILEOPT = GCC_OPT + [
 ]
 GCC_DEBUG = _GCC_COMPILEOPT + ["-D", "DEBUG", "-Og", "-Wall"]
 GCC_MAIN = _GCC_COMPILEOPT + ["-O3"]
+# interpreter objects packed into 8 bytes, see headers/interpreter/object.h
+GCC_NANBOX = GCC_MAIN + ["-D", "NAN_BOXING"]
+# position independent, only the mylang_* functions exported, see headers/interpreter/mylang.h
+GCC_LIBRARY = GCC_MAIN + ["-fPIC", "-fvisibility=hidden"]
+# micro-benchmarks are compiled and linked at once, with the sources they measure
+GCC_BENCH = GCC_OPT + ["-include", debug, "-iquote", headers, "-fshort-enums", "-O3"]
 
 
 def task_debug() :
@@ -135,4 +145,188 @@ def task_debug() :
 def task_release() :
     yield from generic_build(src, buildpath, GCC_MAIN, GCC_LINKOPT)
 
+def task_nanbox() :
+    yield from generic_build(src, buildpath, GCC_NANBOX, GCC_LINKOPT, "nanbox")
+
+def task_library() :
+    """libmylang.so: the interpreter, minus its command line"""
+    objects = list()
+    for srcdir in (src, src / "interpreter") :
+        for path in srcdir.iterdir() :
+            if not path.is_file() or path.name == "main.c" : continue
+            dst = buildpath / f"{srcdir.name}__{path.name}.lib.o"
+            objects.append(dst)
+            yield {
+                "name" : dst.name,
+                "targets" : [dst],
+                "file_dep" : [path],
+                "actions" : [COMPILER + GCC_LIBRARY + ["-o", dst] + [path]],
+                "clean" : True,
+            }
+    target = Path("libmylang.so")
+    yield {
+        "name" : target.name,
+        "targets" : [target],
+        "file_dep" : objects,
+        "actions" : [COMPILER + GCC_LINKOPT + ["-shared", "-o", target] + objects],
+        "clean" : True,
+    }
+
+# programs the alternative VMs once got wrong: runs longer than 128 each way,
+# more pairs than fit in a computation array, and a script (freeProgram(NULL) at its end)
+ALTVM_CHECKS = {
+    "long_minus.bf" : "-"*200 + ".",
+    "long_left.bf" : ">"*300 + "+"*65 + "<"*200 + "+"*66 + "<"*100 + "." + ">"*100 + ".",
+    "many_pairs.bf" : ">+"*40 + "<"*40 + ">."*40,
+    "script.myc" : "int a = 3;\nprint(a);\n",
+}
+
+def check_altvm() :
+    ok = True
+    for name, program in ALTVM_CHECKS.items() :
+        path = buildpath / f"check_{name}"
+        path.write_text(program)
+        command = ["-s", path, "-O", "-"] if name.endswith(".myc") else ["-I", path, "-x"]
+        outputs = {flavor : subprocess.run([f"./{flavor}"] + command, stdin=subprocess.DEVNULL, stdout=subprocess.PIPE).stdout
+                   for flavor in ("compile", "altvm_c", "altvm_s")}
+        for flavor in ("altvm_c", "altvm_s") :
+            if outputs[flavor] != outputs["compile"] :
+                print(f"{name}: {flavor} differs from compile")
+                ok = False
+    return ok
+
+def task_check_altvm() :
+    """the alternative VMs against the regular one (release builds)"""
+    return {
+        "actions" : [(check_altvm,)],
+        "file_dep" : [Path("compile"), Path("altvm_c"), Path("altvm_s")],
+        "verbosity" : 2,
+    }
+
+def task_bench_intern() :
+    """micro-benchmark of the identifiers record, on a generated program"""
+    sources = [Path("benchmarks/intern.c"), src / "identifiers_record.c", src / "hash.c", src / "arena.c"]
+    target = buildpath / "bench_intern"
+    return {
+        "targets" : [target],
+        "file_dep" : sources,
+        "actions" : [COMPILER + GCC_BENCH + ["-o", target] + sources, [target]],
+        "verbosity" : 2,
+        "clean" : True,
+    }
+
+def task_bench_hash() :
+    """the default string hash against FNV-1a, on the identifiers of the sources of the project"""
+    sources = [Path("benchmarks/intern.c"), src / "identifiers_record.c", src / "hash.c", src / "arena.c"]
+    corpus = sorted(src.glob("**/*.c")) + sorted(headers.glob("**/*.h"))
+    for name, options in (("default", []), ("fnv", ["-D", "HASH_FNV"])) :
+        target = buildpath / f"bench_hash_{name}"
+        yield {
+            "name" : name,
+            "targets" : [target],
+            "file_dep" : sources + corpus,
+            "actions" : [COMPILER + GCC_BENCH + options + ["-o", target] + sources, [target] + corpus],
+            "verbosity" : 2,
+            "clean" : True,
+        }
+
+"""
+Benchmarks of the whole executables, release build, on the programs of benchmarks/:
+* bf/*.bf run on the three brainfuck VMs (compile, altvm_c, altvm_s);
+* compiler/*.myc are compiled (not run) by the three of them, repeated to take some time;
+* interpreter/*.my run on the interpreter.
+Each workload runs BENCH_RUNS times through benchmarks/measure.c, we keep the medians
+of the wall time and of the instructions, and the peak RSS.
+"""
+
+benchdir = Path("benchmarks/")
+BENCH_FLAVORS = ["compile", "altvm_c", "altvm_s", "interpreter"]
+BENCH_MEASURE = buildpath / "bench_measure"
+BENCH_RUNS = 5
+BENCH_REPEAT = 1000 # copies of each compiler/ script
+BENCH_TOLERANCE = 0.1 # 10% slower than the baseline is a regression; instructions get a fifth of it
+
+def bench_workloads() :
+    """(name, flavor, command line) of each workload"""
+    for path in sorted((benchdir / "bf").glob("*.bf")) :
+        for flavor in ("compile", "altvm_c", "altvm_s") :
+            yield f"bf/{path.stem}", flavor, [f"./{flavor}", "-I", path, "-x"]
+    for path in sorted((benchdir / "compiler").glob("*.myc")) :
+        script = buildpath / f"bench_{path.name}"
+        for flavor in ("compile", "altvm_c", "altvm_s") :
+            yield f"compiler/{path.stem}", flavor, [f"./{flavor}", "-s", script, "-o", os.devnull]
+    for path in sorted((benchdir / "interpreter").glob("*.my")) :
+        yield f"interpreter/{path.stem}", "interpreter", ["./interpreter", "--no-cache", path]
+
+def bench_measure(command) :
+    """wall time (s), peak RSS (kB), instructions (None if unknown) of one run"""
+    output = subprocess.run([BENCH_MEASURE] + command, stdout=subprocess.PIPE, text=True, check=True).stdout
+    wall, rss, instructions = output.split()
+    return float(wall), int(rss), (int(instructions) if int(instructions) >= 0 else None)
+
+def bench_compare(results, baseline_path, tolerance) :
+    """prints the ratios to the baseline, returns False on any regression"""
+    baseline = {(r["workload"], r["flavor"]) : r for r in json.loads(Path(baseline_path).read_text())}
+    ok = True
+    print(f"\ncompared to {baseline_path}:")
+    for r in results :
+        old = baseline.get((r["workload"], r["flavor"]))
+        if old is None : continue
+        ratios = [("time", r["median_s"] / old["median_s"], tolerance),
+                  ("rss", r["max_rss_kb"] / old["max_rss_kb"], tolerance)]
+        if r["instructions"] and old["instructions"] :
+            ratios.append(("instructions", r["instructions"] / old["instructions"], tolerance / 5))
+        flagged = [name for name, ratio, limit in ratios if ratio > 1 + limit]
+        ok = ok and not flagged
+        print(f"{r['workload']:<24} {r['flavor']:<12}"
+              + "".join(f" {name} x{ratio:.3f}" for name, ratio, _ in ratios)
+              + ("  REGRESSION: " + ", ".join(flagged) if flagged else ""))
+    return ok
+
+def bench_run(runs, output, compare, tolerance) :
+    for path in sorted((benchdir / "compiler").glob("*.myc")) :
+        (buildpath / f"bench_{path.name}").write_text(path.read_text() * BENCH_REPEAT)
+    results = list()
+    for workload, flavor, command in bench_workloads() :
+        measures = [bench_measure([str(arg) for arg in command]) for _ in range(runs)]
+        counts = [instructions for _, _, instructions in measures if instructions is not None]
+        results.append({
+            "workload" : workload,
+            "flavor" : flavor,
+            "wall_s" : [wall for wall, _, _ in measures],
+            "median_s" : statistics.median(wall for wall, _, _ in measures),
+            "max_rss_kb" : max(rss for _, rss, _ in measures),
+            "instructions" : int(statistics.median(counts)) if counts else None,
+        })
+        r = results[-1]
+        print(f"{workload:<24} {flavor:<12} {r['median_s']:8.3f} s {r['max_rss_kb']:8} kB {r['instructions'] or '-':>14} instructions")
+    Path(output).write_text(json.dumps(results, indent=1))
+    print(f"results in {output}")
+    if compare : return bench_compare(results, compare, tolerance)
+
+def task_bench_measure() :
+    """runs a command and measures it, for `doit bench`"""
+    source = benchdir / "measure.c"
+    return {
+        "targets" : [BENCH_MEASURE],
+        "file_dep" : [source],
+        "actions" : [COMPILER + GCC_BENCH + ["-o", BENCH_MEASURE, source]],
+        "clean" : True,
+    }
+
+def task_bench() :
+    """times benchmarks/ on every release flavor; --compare <results.json> flags the regressions"""
+    return {
+        "actions" : [(bench_run,)],
+        "file_dep" : [Path(flavor) for flavor in BENCH_FLAVORS] + [BENCH_MEASURE],
+        "uptodate" : [False], # timings change without the sources changing
+        "params" : [
+            {"name" : "runs", "long" : "runs", "type" : int, "default" : BENCH_RUNS, "help" : "runs of each workload"},
+            {"name" : "output", "long" : "output", "default" : str(buildpath / "bench.json"), "help" : "where the results go"},
+            {"name" : "compare", "long" : "compare", "default" : "", "help" : "results of a previous run, to compare with"},
+            {"name" : "tolerance", "long" : "tolerance", "type" : float, "default" : BENCH_TOLERANCE, "help" : "slowdown flagged as a regression"},
+        ],
+        "verbosity" : 2,
+    }
+
 DOIT_CONFIG = {'default_tasks': ['debug']}
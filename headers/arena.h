@@ -0,0 +1,24 @@
+#ifndef arena_h
+#define arena_h
+
+#include <stddef.h>
+
+typedef struct ArenaChunk ArenaChunk;
+
+/*
+A bump allocator: allocations can't be freed one by one, everything goes at
+once with `arena_reset` or `del_arena`.
+*/
+typedef struct Arena {
+        ArenaChunk* chunks; // the chunk we allocate from is the first one
+} Arena;
+
+void mk_arena(Arena *const arena);
+void del_arena(Arena *const arena);
+
+// the returned memory is suitably aligned for any type
+void* arena_alloc(Arena *const arena, const size_t size);
+// frees everything allocated so far, but keeps memory around for reuse
+void arena_reset(Arena *const arena);
+
+#endif
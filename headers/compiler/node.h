@@ -49,7 +49,7 @@ typedef enum {
 } Operator;
 
 typedef struct Node {
-        LocalizedToken token;
+        Token token;
         Operator operator;
         RuntimeType type;
 
@@ -62,6 +62,4 @@ typedef struct Node {
         } operands[];
 } Node;
 
-void freeNode(Node* node);
-
 #endif
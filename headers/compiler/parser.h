@@ -2,6 +2,7 @@
 #define parser_h
 
 #include "lexer.h"
+#include "arena.h"
 #include "compiler/node.h"
 #include "compiler/runtime_types.h"
 
@@ -10,8 +11,10 @@ typedef struct parser_info parser_info;
 struct parser_info {
         struct lexer_info lxinfo;
         struct ResolverRecord* resolv;
-        LocalizedToken last_produced;
-        char stale; // state of the token, 1 if it needs to be refreshed
+        Arena nodes; // the nodes of the statement being compiled
+        struct Node** pending; // children of the variable-arity nodes being parsed
+        size_t pending_top;
+        size_t pending_len;
 };
 
 void mk_parser_info(parser_info *const prsinfo);
@@ -19,5 +22,7 @@ void del_parser_info(parser_info *const prsinfo);
 
 struct ResolverRecord* record_variable(struct ResolverRecord* record, char const* key, size_t arity, RuntimeType type);
 Node* parse_statement(parser_info *const state);
+// frees all the nodes parsed so far, at once
+void release_nodes(parser_info *const prsinfo);
 
 #endif
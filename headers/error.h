@@ -3,7 +3,27 @@
 
 #include "token.h"
 
-void Error(const LocalizedToken* where, const char* message, ...) __attribute__((format(printf, 2, 3)));
-void Warning(const LocalizedToken* where, const char* message, ...) __attribute__((format(printf, 2, 3)));
+struct lexer_info;
+
+void Error(const Token* where, const char* message, ...) __attribute__((format(printf, 2, 3)));
+void Warning(const Token* where, const char* message, ...) __attribute__((format(printf, 2, 3)));
+
+// where the errors and warnings of the current thread go; to stderr if `report` is NULL
+typedef struct Reporter {
+        void (*report)(void* userdata, const int is_error, const Token* where, const Localization pos, const char* message);
+        void* userdata;
+} Reporter;
+
+void set_reporter(const Reporter reporter);
+
+/*
+The lexer the tokens of the current thread come from, to turn their offsets
+into lines and columns. A new lexer makes itself the source.
+*/
+void set_error_source(struct lexer_info* lxinfo);
+// if <lxinfo> is the source, there is none any more
+void drop_error_source(const struct lexer_info* lxinfo);
+// the line and column of <offset> in the source, both 0 if there is no source
+Localization source_position(const SourceOffset offset);
 
 #endif
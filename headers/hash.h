@@ -2,11 +2,35 @@
 #define hash_h
 
 #include <stdint.h>
+#include <stddef.h>
+
+/*
+String hashes, for the identifiers record, the keywords and the cache keys.
+By default, a wyhash-style hash reading 8 bytes at a time; build with
+-D HASH_FNV to get FNV-1a back, a byte at a time.
+Hashes aren't stable from one build to another.
+*/
 
 typedef uintptr_t hash_t;
 
+// to hash data that comes in pieces: the result is the same as hashing it all at once
+typedef struct HashState {
+#ifdef HASH_FNV
+        hash_t hash;
+#else
+        uint64_t seed;
+        uint64_t length;
+        unsigned char pending[16]; // start of a block, not mixed in yet
+        unsigned int nb_pending;
+#endif
+} HashState;
+
+void hash_start(HashState *const state);
+void hash_update(HashState *const state, char const* data, const size_t len);
+hash_t hash_finish(const HashState *const state);
+
 hash_t hash_string(char const* string);
-hash_t hash_stringn(char const* string, const unsigned short len);
-hash_t resume_hashing(char const* string, hash_t hash);
+hash_t hash_stringn(char const* string, const size_t len);
+hash_t hash_bytes(char const* data, const size_t len);
 
 #endif
@@ -2,23 +2,38 @@
 #define identifiers_record_h
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "hash.h"
+#include "arena.h"
 
 typedef struct Identifier {
-        char* source;
+        char* source; // in the arena of the record
         hash_t hash;
+        size_t length;
 } Identifier;
 
+/*
+Open addressing, probed by groups of 16 slots: each slot has a control byte,
+either empty or 7 bits of the hash of its identifier, and a group is matched
+against a hash in a single SSE2 comparison.
+The strings are never moved nor freed before the record: an identifier is
+known by its address, as long as the record lives.
+*/
 typedef struct IdentifiersRecord {
-        size_t len; // guaranteed to be a power of 2
+        size_t capacity; // slots, a power of 2
         size_t nb_entries;
-        Identifier pool[];
+        uint8_t* control;
+        Identifier* slots;
+        Arena strings;
 } IdentifiersRecord;
 
-IdentifiersRecord* allocateRecord(void);
-void freeRecord(IdentifiersRecord* pool);
+void mk_identifiers_record(IdentifiersRecord *const record);
+void del_identifiers_record(IdentifiersRecord *const record);
 
-char* internalize(IdentifiersRecord **const record, char *const string, unsigned short length);
+// returns the record's copy of string[0:length], null-terminated; the record never keeps <string>
+char* internalize(IdentifiersRecord *const record, const char* string, const size_t length);
+// same, with the hash_stringn() of the string already at hand
+char* internalize_hashed(IdentifiersRecord *const record, const char* string, const size_t length, const hash_t hash);
 
 #endif
@@ -0,0 +1,39 @@
+#ifndef bigint_h
+#define bigint_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "interpreter/gc.h"
+
+typedef struct Object Object;
+
+/*
+Integers that don't fit in an intmax_t. Ints overflow into bigints, and
+bigints are always normalized back: a result that fits is a regular int, so
+an int and a bigint are never equal.
+The magnitude is stored in 64-bit limbs, least significant first.
+*/
+typedef struct ObjBigInt {
+        GCObject gc;
+        size_t len; // the most significant limb is never 0
+        int negative;
+        uint64_t limbs[];
+} ObjBigInt;
+
+// the operands are ints, bools or bigints
+Object bigint_add(const Object a, const Object b);
+Object bigint_sub(const Object a, const Object b);
+Object bigint_mul(const Object a, const Object b);
+Object bigint_negate(const Object a);
+double bigint_div(const Object a, const Object b); // rounded to the nearest double
+int bigint_compare(const Object a, const Object b); // <0, 0 or >0
+
+double bigint_to_double(const Object a);
+// returns ERROR unless <string> is made of decimal digits, with an optional sign
+Object bigint_parse(const char* string, const size_t len);
+struct ObjString* bigint_to_string(const ObjBigInt* big);
+
+void free_bigint(ObjBigInt* big); // only for the garbage collector
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef cache_h
+#define cache_h
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "interpreter/parser.h"
+#include "interpreter/node.h"
+
+/*
+Precompiled scripts: the resolved program AST is dumped next to the script,
+so that later runs of the same source skip lexing, parsing and resolution.
+The dump is only valid for the exact same source (length and hash) and
+the exact same build of the interpreter (see CACHE_VERSION in cache.c).
+It is native-endian and not meant to be portable.
+*/
+
+typedef struct CacheKey {
+        uint64_t length;
+        uint64_t hash;
+} CacheKey;
+
+// identifies the contents of <source>, then rewinds it
+CacheKey cache_key(FILE* source);
+
+// returns NULL if the cache file is missing, stale or corrupted
+Node* load_cached_program(parser_info *const prsinfo, const char* cache_path, const CacheKey key);
+// failures are not fatal: the cache is simply not written
+void store_cached_program(const parser_info* prsinfo, const char* cache_path, const CacheKey key, const Node* program);
+
+#endif
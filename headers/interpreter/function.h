@@ -3,14 +3,30 @@
 
 #include <stddef.h>
 
+#include "interpreter/gc.h"
+
+typedef struct Environment {
+        // a frame of the namespace, as long as it runs the same call
+        size_t frame;
+        size_t serial;
+} Environment;
+
 typedef struct ObjFunction {
+        GCObject gc;
         struct Node* body;
+        unsigned int level; // lexical nesting level, 1 for functions defined at top level
+        Environment env; // the frame the function was created in; the globals for the ones in the AST
+        size_t frame_size; // number of locals, parameters included; set by the resolver
         size_t arity;
         char* arguments[];
 } ObjFunction;
 
 ObjFunction* createFunction(const size_t arity);
 ObjFunction* reallocFunction(ObjFunction* fun, const size_t arity);
+// a registered copy of <fun>, sharing its body, that runs in <env>
+ObjFunction* bindFunction(const ObjFunction* fun, const Environment env);
+// hands the function over to the garbage collector, once it won't move anymore
+void registerFunction(ObjFunction* fun);
 void free_function(ObjFunction* function);
 
 #endif
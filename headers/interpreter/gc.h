@@ -0,0 +1,59 @@
+#ifndef gc_h
+#define gc_h
+
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+Heap objects (strings, user-defined functions, bigints, and boxed ints in
+NaN-boxing builds) start with a GCObject header.
+Allocations only request a collection; it happens at the next safe point, i.e.
+the beginning of a statement, so that half-built values never need to be rooted.
+Roots are the value stack, the staging slot, the evaluation stack, and the
+top-level statement being run (see Namespace).
+*/
+
+typedef enum GCKind {
+        GC_STRING,
+        GC_FUNCTION,
+        GC_INT,
+        GC_BIGINT,
+} GCKind;
+
+typedef struct GCObject {
+        struct GCObject* next;
+        size_t size;
+        GCKind kind;
+        unsigned char marked;
+} GCObject;
+
+typedef struct GCStats {
+        size_t collections;
+        size_t objects_allocated;
+        size_t objects_freed;
+        size_t bytes_allocated; // currently alive
+        size_t bytes_freed;
+        size_t peak_bytes;
+        size_t threshold; // next collection happens past this many bytes
+} GCStats;
+
+// each interpreter instance has its own heap, the functions below work on that of current_vm
+typedef struct GCHeap {
+        GCObject* objects;
+        GCStats stats;
+} GCHeap;
+
+struct Namespace;
+
+void mk_heap(GCHeap *const heap);
+void gc_track(GCObject *const object, const GCKind kind, const size_t size);
+// accounts for memory an object acquired after being tracked
+void gc_grow(GCObject *const object, const size_t extra);
+int gc_pending(void);
+void collect_garbage(struct Namespace *const ns);
+void free_heap(void);
+
+GCStats gc_stats(void);
+void print_gc_stats(FILE* file);
+
+#endif
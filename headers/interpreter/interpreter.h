@@ -8,6 +8,7 @@ typedef enum {
         OK_OK,
         OK_ABORT,
         ERROR_ABORT,
+        TAIL_CALL, // the callee and its arguments are on top of the evaluation stack, the callee is also staged
 } errcode;
 
 typedef struct interpreter_info interpreter_info;
@@ -20,6 +21,10 @@ struct interpreter_info {
 void mk_interpreter_info(interpreter_info *const interp);
 void del_interpreter_info(interpreter_info *const interp);
 
+// streaming mode (REPL): parses and runs the next top-level statement
 errcode interpretStatement(interpreter_info *const interpinfo);
+// parses the whole source before running it, so that syntax errors are reported before any side effect
+// <cache_path> may be NULL, otherwise the parsed program is loaded from or stored to that file
+errcode interpretProgram(interpreter_info *const interpinfo, const char* cache_path);
 
 #endif
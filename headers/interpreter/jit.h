@@ -0,0 +1,38 @@
+#ifndef jit_h
+#define jit_h
+
+#include "interpreter/node.h"
+#include "interpreter/namespace.h"
+
+/*
+Baseline JIT for hot loops, on x86-64 only.
+A while loop that the tree walker has run JIT_THRESHOLD times is compiled to
+machine code, as a whole, if its variables are all ints or bools and it only
+does arithmetic, comparisons and assignments on them: no calls, no floats, no
+strings. The types of the variables are checked on each entry in the loop.
+The code bails out right before a statement it can't run faithfully, when an
+int overflows for instance; the tree walker then resumes from there, and the
+loop is never compiled again.
+*/
+
+#define JIT_THRESHOLD 1000 // iterations
+
+// OP_WHILE nodes carry the state of the JIT in two operands after their children
+#define JIT_HOTNESS 2 // iterations run by the tree walker
+#define JIT_LOOP 3 // NULL until the loop is hot
+
+typedef struct JitLoop JitLoop;
+
+// never returns NULL: a loop that can't be compiled, or any loop of an instance with the JIT off,
+// gets a placeholder, that always declines to run
+JitLoop* jit_compile(const Node* loop, Namespace *const ns);
+/*
+Runs <loop> from the evaluation of its predicate.
+Returns NULL once the loop is over, <loop> if the compiled code can't run with
+the current variables, or the statement (in the loop) to resume from.
+*/
+const Node* jit_run(JitLoop *const jit, const Node* loop, Namespace *const ns);
+
+void jit_release(void); // frees all the code compiled by current_vm
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef mylang_h
+#define mylang_h
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/*
+libmylang, the interpreter as a library.
+An instance (mylang_vm) owns everything a script needs: its globals, its heap,
+its compiled loops, and the callbacks it does I/O through. Instances share
+nothing, so separate instances may run at the same time on separate threads;
+a given instance must only be used by one thread at a time.
+*/
+
+#define MYLANG_API __attribute__((visibility("default")))
+
+typedef struct mylang_vm mylang_vm;
+
+typedef enum mylang_status {
+        MYLANG_OK,
+        MYLANG_ERROR, // a syntax or run time error, already reported
+} mylang_status;
+
+typedef enum mylang_severity {
+        MYLANG_REPORT_ERROR,
+        MYLANG_REPORT_WARNING,
+} mylang_severity;
+
+// any callback left NULL goes to the matching standard stream
+typedef struct mylang_io {
+        void* userdata; // passed to every callback
+        // output of print(), in pieces that aren't null-terminated
+        void (*write)(void* userdata, const char* text, size_t len);
+        // a line for input(), with the contract of getline(3): returns -1 at the end of the input
+        ssize_t (*read_line)(void* userdata, char** line, size_t* capacity);
+        // <near> is the source of the token at fault, <message> ends with a newline
+        void (*report)(void* userdata, mylang_severity severity, unsigned int line, unsigned int column, const char* near, const char* message);
+} mylang_io;
+
+// <io> is copied, and may be NULL
+MYLANG_API mylang_vm* mylang_new(const mylang_io* io);
+MYLANG_API void mylang_free(mylang_vm* vm);
+
+// compiled loops are on by default
+MYLANG_API void mylang_set_jit(mylang_vm* vm, int enabled);
+
+/*
+Parses, then runs a whole script, from a copy of <source>. Successive scripts
+run in the same globals, so that a script may use the functions and variables
+a previous one defined.
+*/
+MYLANG_API mylang_status mylang_run(mylang_vm* vm, const char* source, size_t len);
+
+#endif
@@ -2,25 +2,68 @@
 #define identifiers_pool_h
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "interpreter/object.h"
 
+#define ADDR_GLOBAL UINT32_MAX // `depth` of an address designating a global
+
+typedef struct Address {
+        uint32_t depth; // number of static links to follow from the current frame, or ADDR_GLOBAL
+        uint32_t slot;
+} Address;
+
+typedef struct Frame {
+        size_t base; // index of the first slot in the value stack
+        size_t len; // number of slots materialized so far
+        size_t link; // index of the lexically enclosing frame, SIZE_MAX if it is out of reach
+        size_t serial; // new for each call run in this frame, 0 for globals
+        unsigned int level; // lexical nesting level of the code running in this frame; 0 for globals
+        int captured; // some function was created in this frame, which must then outlive the call
+} Frame;
+
+/*
+Variables are resolved to (depth, slot) pairs at parse time (see the resolver
+in parser.c), so the namespace is nothing more than a stack of frames.
+The global frame is always frames[0], and sits at the bottom of the value stack.
+A function links to the frame it was created in (its environment), if that
+frame still runs the same call; otherwise only the globals are in reach.
+Slots that haven't been assigned yet hold an object of type TYPE_ERROR.
+The evaluation stack holds intermediate values that must survive the
+evaluation of a sibling expression, so that the garbage collector sees them.
+*/
 typedef struct Namespace {
-        char const** keys; // may be NULL, indicating NS push
         Object* values;
-        size_t nb_entries;
         size_t len;
+        Frame* frames;
+        size_t nb_frames;
+        size_t frames_len;
+        size_t serials; // last frame serial handed out
+        Object* stack;
+        size_t stack_top;
+        size_t stack_len;
+        const struct Node* statement; // the top-level statement being run
         Object staging;
 } Namespace;
 
 Namespace allocateNamespace(void);
 void freeNamespace(Namespace* ns);
 
-size_t pushNamespace(Namespace *const ns);
+// pushes a frame for <function>, the first <argc> slots being initialized from <args>
+size_t pushNamespace(Namespace *const ns, const ObjFunction* function, const Object* args, const size_t argc);
 void popNamespace(Namespace *const ns, size_t restore);
+// same as pushNamespace, but replaces the current frame
+// <function> must not be nested in the one currently running
+void reuseNamespace(Namespace *const ns, const ObjFunction* function, const Object* args, const size_t argc);
+// where the functions created now run; the current frame can't be reused by tail calls anymore
+Environment ns_environment(Namespace *const ns);
+
+// returns the index of the pushed value; pop by restoring `stack_top`
+size_t ns_push(Namespace *const ns, Object value);
 
-void ns_set_value(Namespace *const ns, char *const key, Object value);
-Object* ns_get_value(Namespace *const ns, const char* key);
-Object* ns_get_rw_value(Namespace *const pool, const char* key);
+// can only write to the current frame, or to the global frame when it is the current one
+void ns_set_value(Namespace *const ns, const Address addr, Object value);
+// returns NULL if the slot is unset or out of reach
+Object* ns_get_value(Namespace *const ns, const Address addr);
 
 #endif
@@ -3,6 +3,7 @@
 
 #include "token.h"
 #include "interpreter/object.h"
+#include "interpreter/namespace.h"
 
 typedef enum {
         // no operand
@@ -16,12 +17,17 @@ typedef enum {
 
         LAST_OP_LITERAL=OP_LITERAL_STR, // not actually an operator
 
+        // addresses only, see the resolver
         OP_VARIABLE,
+        OP_FORGET, // unsets the slots of hoisted expressions, see the optimizer
+
+        LAST_OP_LEAF=OP_FORGET, // not actually an operator
 
         // one operand
         OP_UNARY_PLUS,
         OP_UNARY_MINUS,
         OP_INVERT,
+        OP_INVARIANT, // evaluated once, then kept in the slot whose address follows the operand
 
         // two operands
         OP_SUM,
@@ -39,6 +45,24 @@ typedef enum {
         OP_LT,
         OP_LE,
 
+        // quickened variants of the above, installed by the interpreter at run time
+        OP_SUM_INT_INT,
+        OP_SUM_FLOAT_FLOAT,
+        OP_DIFFERENCE_INT_INT,
+        OP_DIFFERENCE_FLOAT_FLOAT,
+        OP_PRODUCT_INT_INT,
+        OP_PRODUCT_FLOAT_FLOAT,
+        OP_DIVISION_FLOAT_FLOAT,
+        OP_EQ_INT_INT,
+        OP_LT_INT_INT,
+        OP_LT_FLOAT_FLOAT,
+        OP_LE_INT_INT,
+        OP_LE_FLOAT_FLOAT,
+        OP_IADD_INT_INT,
+        OP_IADD_FLOAT_FLOAT,
+        OP_ISUB_INT_INT,
+        OP_ISUB_FLOAT_FLOAT,
+
         OP_CALL,
         OP_RETURN,
 
@@ -52,7 +76,7 @@ typedef enum {
 } Operator;
 
 typedef struct Node {
-        LocalizedToken token;
+        Token token;
         Operator operator;
         /*note about the f.a.m.:
         For nodes that don't have a fixed number of children, the first element of this array is an uintptr_t that will indicate the number of children this array contains. In that case, the first child (if present) will be found at index 1.
@@ -61,9 +85,17 @@ typedef struct Node {
                 struct Node* nd;
                 uintptr_t len;
                 ObjectCore obj;
+                Address addr;
+                struct JitLoop* jit;
         } operands[];
 } Node;
 
-void freeNode(Node* node);
+// child nodes are found in operands[first..end); some of them may be NULL
+typedef struct ChildRange {
+        uintptr_t first;
+        uintptr_t end;
+} ChildRange;
+
+ChildRange childRange(const Node* node);
 
 #endif
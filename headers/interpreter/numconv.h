@@ -0,0 +1,34 @@
+#ifndef numconv_h
+#define numconv_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+Numbers to and from text, independently of the C locale.
+Ints are written in decimal; floats in the shortest form that reads back as the
+same double (Grisu2, then shortened exactly), laid out like Python's repr: "0.1", "1.0", "1e+16".
+Parsing is strict: the whole text must be a number, without surrounding spaces.
+*/
+
+#define INT_CHARS 20 // the longest int, INTMAX_MIN, has 19 digits and a sign
+#define FLOAT_CHARS 32
+
+typedef enum ParseResult {
+        PARSE_OK,
+        PARSE_INVALID,
+        PARSE_OVERFLOW, // well-formed, but too large for the type
+} ParseResult;
+
+// writes `value` right before `end`, returns where it starts
+char* format_int(const intmax_t value, char *const end);
+// returns the number of characters written to `buffer`, which is not null-terminated
+size_t format_float(const double value, char buffer[FLOAT_CHARS]);
+
+// an optional sign, then decimal digits
+ParseResult parse_int(const char* text, const size_t len, intmax_t *const value);
+// an optional sign, then digits with an optional point and exponent, "inf" or "nan"
+// out-of-range values give an infinity or zero, like strtod
+ParseResult parse_float(const char* text, const size_t len, double *const value);
+
+#endif
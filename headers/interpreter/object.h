@@ -2,9 +2,12 @@
 #define object_h
 
 #include <stdint.h>
+#include <string.h>
 
+#include "interpreter/gc.h"
 #include "interpreter/string.h"
 #include "interpreter/function.h"
+#include "interpreter/bigint.h"
 
 typedef struct Object Object;
 
@@ -19,6 +22,7 @@ typedef enum ObjType {
         TYPE_STRING,
         TYPE_NATIVEF,
         TYPE_USERF,
+        TYPE_BIGINT, // only ever built by integer operations that overflow
 
         LEN_OBJTYPES // do NOT add anything below this line!
 } ObjType;
@@ -31,6 +35,101 @@ typedef union ObjectCore {
         native_function* natfunval;
 } ObjectCore;
 
+/*
+Objects are only ever built and inspected through the macros below, so that
+their representation can be picked at build time :
+* by default, a type tag next to an ObjectCore (16 bytes);
+* with -D NAN_BOXING, a single 64-bit word (see below).
+Bools are ints as far as AS_INT is concerned.
+*/
+
+#ifdef NAN_BOXING
+
+/*
+Doubles are stored as is, with NaNs canonicalized to a positive quiet NaN.
+Any word at or above 0xFFF1 << 48 is a negative NaN that no double can produce
+anymore, its top 16 bits hold the tag and the 48 low bits the payload:
+pointers (user space is 48 bits wide on x86-64 and aarch64), bools, and ints
+that fit in 48 bits. Wider ints are boxed on the heap.
+*/
+typedef struct ObjInt {
+        GCObject gc;
+        intmax_t value;
+} ObjInt;
+
+ObjInt* box_int(intmax_t value);
+void free_boxed_int(ObjInt* box); // only for the garbage collector
+
+struct Object {
+        uint64_t bits;
+};
+
+#define NANBOX_CANONICAL_NAN UINT64_C(0x7FF8000000000000)
+#define NANBOX_TAG(tag) ((UINT64_C(0xFFF1) + (tag)) << 48)
+#define NANBOX_TAG_BOXED_INT NANBOX_TAG(LEN_OBJTYPES)
+#define NANBOX_PAYLOAD UINT64_C(0x0000FFFFFFFFFFFF)
+#define NANBOX_INT_MIN (-(INTMAX_C(1) << 47))
+#define NANBOX_INT_MAX ((INTMAX_C(1) << 47) - 1)
+
+static inline ObjType OBJ_TYPE(const Object obj) {
+        if (obj.bits < NANBOX_TAG(0)) return TYPE_FLOAT;
+        if ((obj.bits & ~NANBOX_PAYLOAD) == NANBOX_TAG_BOXED_INT) return TYPE_INT;
+        return (obj.bits >> 48) - 0xFFF1;
+}
+static inline void* nanbox_pointer(const Object obj) {
+        return (void*) (uintptr_t) (obj.bits & NANBOX_PAYLOAD);
+}
+
+static inline intmax_t AS_INT(const Object obj) {
+        if ((obj.bits & ~NANBOX_PAYLOAD) == NANBOX_TAG_BOXED_INT) return ((ObjInt*) nanbox_pointer(obj))->value;
+        return ((int64_t) (obj.bits << 16)) >> 16; // sign extension
+}
+static inline double AS_FLOAT(const Object obj) {
+        double value;
+        memcpy(&value, &(obj.bits), sizeof(value));
+        return value;
+}
+#define AS_STRING(obj) ((ObjString*) nanbox_pointer(obj))
+#define AS_USERF(obj) ((ObjFunction*) nanbox_pointer(obj))
+#define AS_NATIVEF(obj) ((native_function*) nanbox_pointer(obj))
+#define AS_BIGINT(obj) ((ObjBigInt*) nanbox_pointer(obj))
+
+static inline Object OBJ_INT(const intmax_t value) {
+        if (value < NANBOX_INT_MIN || value > NANBOX_INT_MAX) {
+                return (Object) {.bits=NANBOX_TAG_BOXED_INT | (uintptr_t) box_int(value)};
+        }
+        return (Object) {.bits=NANBOX_TAG(TYPE_INT) | ((uint64_t) value & NANBOX_PAYLOAD)};
+}
+static inline Object OBJ_FLOAT(const double value) {
+        Object obj;
+        if (value != value) obj.bits = NANBOX_CANONICAL_NAN;
+        else memcpy(&(obj.bits), &value, sizeof(value));
+        return obj;
+}
+#define OBJ_BOOL(value) ((Object) {.bits=NANBOX_TAG(TYPE_BOOL) | ((uint64_t) (intmax_t) (value) & NANBOX_PAYLOAD)})
+#define OBJ_STRING(str) ((Object) {.bits=NANBOX_TAG(TYPE_STRING) | (uintptr_t) (str)})
+#define OBJ_USERF(fun) ((Object) {.bits=NANBOX_TAG(TYPE_USERF) | (uintptr_t) (fun)})
+#define OBJ_NATIVEF(fun) ((Object) {.bits=NANBOX_TAG(TYPE_NATIVEF) | (uintptr_t) (fun)})
+#define OBJ_BIGINT(big) ((Object) {.bits=NANBOX_TAG(TYPE_BIGINT) | (uintptr_t) (big)})
+
+#define ERROR ((Object){.bits=NANBOX_TAG(TYPE_ERROR)})
+#define OBJ_NONE ((Object){.bits=NANBOX_TAG(TYPE_NONE)})
+
+static inline GCObject* heap_object(const Object obj) {
+        // the heap object referenced by `obj`, if any
+        switch (obj.bits & ~NANBOX_PAYLOAD) {
+                case NANBOX_TAG(TYPE_STRING):
+                case NANBOX_TAG(TYPE_USERF):
+                case NANBOX_TAG(TYPE_BIGINT):
+                case NANBOX_TAG_BOXED_INT:
+                        return nanbox_pointer(obj);
+                default:
+                        return NULL;
+        }
+}
+
+#else
+
 struct Object {
         ObjType type;
         union {
@@ -39,14 +138,48 @@ struct Object {
                 ObjString* strval;
                 ObjFunction* funval;
                 native_function* natfunval;
+                ObjBigInt* bigval;
         };
 };
 
-#define ERROR_GUARD(obj) if((obj).type == TYPE_ERROR) return ERROR
+#define OBJ_TYPE(obj) ((obj).type)
+#define AS_INT(obj) ((obj).intval)
+#define AS_FLOAT(obj) ((obj).floatval)
+#define AS_STRING(obj) ((obj).strval)
+#define AS_USERF(obj) ((obj).funval)
+#define AS_NATIVEF(obj) ((obj).natfunval)
+#define AS_BIGINT(obj) ((obj).bigval)
+
+#define OBJ_INT(value) ((Object){.type=TYPE_INT, .intval=(value)})
+#define OBJ_FLOAT(value) ((Object){.type=TYPE_FLOAT, .floatval=(value)})
+#define OBJ_BOOL(value) ((Object){.type=TYPE_BOOL, .intval=(value)})
+#define OBJ_STRING(str) ((Object){.type=TYPE_STRING, .strval=(str)})
+#define OBJ_USERF(fun) ((Object){.type=TYPE_USERF, .funval=(fun)})
+#define OBJ_NATIVEF(fun) ((Object){.type=TYPE_NATIVEF, .natfunval=(fun)})
+#define OBJ_BIGINT(big) ((Object){.type=TYPE_BIGINT, .bigval=(big)})
 
 #define ERROR ((Object){.type=TYPE_ERROR})
 #define OBJ_NONE ((Object){.type=TYPE_NONE})
-#define OBJ_TRUE ((Object){.type=TYPE_BOOL, .intval=1})
-#define OBJ_FALSE ((Object){.type=TYPE_BOOL, .intval=0})
+
+static inline GCObject* heap_object(const Object obj) {
+        // the heap object referenced by `obj`, if any
+        switch (obj.type) {
+                case TYPE_STRING:
+                        return &(obj.strval->gc);
+                case TYPE_USERF:
+                        return &(obj.funval->gc);
+                case TYPE_BIGINT:
+                        return &(obj.bigval->gc);
+                default:
+                        return NULL;
+        }
+}
+
+#endif
+
+#define OBJ_TRUE OBJ_BOOL(1)
+#define OBJ_FALSE OBJ_BOOL(0)
+
+#define ERROR_GUARD(obj) if(OBJ_TYPE(obj) == TYPE_ERROR) return ERROR
 
 #endif
@@ -0,0 +1,17 @@
+#ifndef optimizer_h
+#define optimizer_h
+
+#include "interpreter/parser.h"
+#include "interpreter/node.h"
+
+/*
+Rewrites a resolved top-level statement (or program) before it first runs :
+* operations on literals are folded into a literal;
+* `if`s and `while`s with a literal predicate lose their dead branch;
+* pure expressions that a `while` loop can't change are only evaluated once
+per entry in the loop (see OP_INVARIANT and OP_FORGET).
+New nodes come from the parser's arena, hoisted values get slots of their own.
+*/
+Node* optimize(parser_info *const prsinfo, Node* root);
+
+#endif
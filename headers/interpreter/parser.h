@@ -4,18 +4,31 @@
 #include <stdint.h> // for the uintptr_t, may be needed in the use of Nodes
 
 #include "lexer.h"
+#include "arena.h"
 #include "interpreter/node.h"
 
 typedef struct parser_info {
         lexer_info lxinfo;
-        LocalizedToken last_produced;
+        struct ResolverRecord* globals;
+        Arena nodes; // every node lives here until the parser is deleted, function bodies included
+        struct Node** pending; // children of the variable-arity nodes being parsed
+        size_t pending_top;
+        size_t pending_len;
         unsigned int func_def_depth;
-        char stale; // state of the token, 1 if it needs to be refreshed
 } parser_info;
 
 void mk_parser_info(parser_info *const prsinfo);
 void del_parser_info(parser_info *const prsinfo);
+// parses whatever the lexer lexes next, keeping the globals and the nodes parsed so far
+void restart_parser(parser_info *const prsinfo);
 
+uint32_t record_global(parser_info *const prsinfo, char const* key);
+size_t nb_globals(const parser_info* prsinfo);
+char const* global_name(const parser_info* prsinfo, const uint32_t slot);
+// room for <nb_children> operands
+Node* allocateNode(parser_info *const prsinfo, const uintptr_t nb_children);
 Node* parse_statement(parser_info *const state);
+// parses the source up to EOF; returns NULL on syntax error
+Node* parse_program(parser_info *const state);
 
 #endif
@@ -0,0 +1,35 @@
+#ifndef profiler_h
+#define profiler_h
+
+#include <stdio.h>
+
+#include "interpreter/node.h"
+#include "interpreter/function.h"
+
+/*
+Per-node profiler, enabled at run time (--profile).
+Each node the interpreter visits is counted and timed; its self time (minus
+that of the nodes it evaluated) is charged to its source position, under the
+stack of user-defined functions being run.
+The results come out as folded stacks ("<main>;f@3;line 4:9 <ns>"), the input
+format of flamegraph tools, and as a summary of the hottest positions.
+It is process-wide, for the command line only: library instances never start it.
+*/
+
+extern int profiling;
+
+void start_profiler(void);
+// writes the results, then releases everything
+void stop_profiler(FILE* folded, FILE* summary);
+
+// around the evaluation of a node, nested
+void profile_enter(const Node* node);
+void profile_exit(void);
+
+// <call> is the OP_CALL node that evaluated <function>
+void profile_call(const Node* call, const ObjFunction* function);
+// the running function gives way to <function>, without a frame of its own
+void profile_tail_call(const Node* call, const ObjFunction* function);
+void profile_return(void);
+
+#endif
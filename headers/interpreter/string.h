@@ -3,15 +3,31 @@
 
 #include <stdint.h>
 
+#include "interpreter/gc.h"
+
+/*
+Concatenation is lazy : it builds a rope node referencing both operands,
+so that `s += piece` in a loop is linear rather than quadratic.
+The characters are only gathered into a contiguous buffer the first time
+someone asks for them through stringValue().
+Short results are copied right away, a rope node wouldn't be worth it.
+*/
 typedef struct ObjString {
+        GCObject gc;
         intmax_t len;
-        char value[];
+        struct ObjString* left; // pending concatenation of `left` and `right`; both NULL once flat
+        struct ObjString* right;
+        char* value; // NULL until flattened; use stringValue()
+        char chars[]; // storage for strings created flat
 } ObjString;
 
 ObjString* makeString(const char* string, intmax_t len);
 
-ObjString* concatenateStrings(const ObjString* strA, const ObjString* strB);
-ObjString* multiplyString(const ObjString* str, intmax_t amount);
+ObjString* concatenateStrings(ObjString* strA, ObjString* strB);
+ObjString* multiplyString(ObjString* str, intmax_t amount);
+
+// returns the null-terminated characters, flattening the string if needed
+const char* stringValue(ObjString* str);
 
-void free_string(ObjString* container);
+void free_string(ObjString* container); // only for the garbage collector
 #endif
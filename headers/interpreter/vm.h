@@ -0,0 +1,35 @@
+#ifndef vm_h
+#define vm_h
+
+#include <stdio.h>
+
+#include "interpreter/mylang.h"
+#include "interpreter/pipeline.h"
+#include "interpreter/gc.h"
+
+struct JitLoop;
+
+struct mylang_vm {
+        pipeline_state pipeline;
+        GCHeap heap;
+        struct JitLoop* compiled_loops;
+        int jit_enabled;
+        mylang_io io; // all callbacks set
+};
+
+/*
+The instance running on the current thread, for the code that has no
+namespace at hand: allocations, compiled loops, builtins doing I/O.
+Entering an instance also routes Error() and Warning() to it.
+*/
+extern _Thread_local mylang_vm* current_vm __attribute__((tls_model("initial-exec")));
+
+// the source is read from <file>, which may be NULL until the instance runs; input() only exists if <with_input>
+mylang_vm* mk_vm(const mylang_io* io, FILE* file, const int with_input);
+void del_vm(mylang_vm* vm);
+
+// returns the instance that was running, to be given back to leave_vm
+mylang_vm* enter_vm(mylang_vm* vm);
+void leave_vm(mylang_vm* previous);
+
+#endif
@@ -2,6 +2,7 @@
 #define keywords_h
 
 #include "token.h"
+#include "hash.h"
 
 typedef struct Keyword Keyword;
 struct Keyword {
@@ -9,4 +10,19 @@ struct Keyword {
         TokenType type;
 };
 
+#define KEYWORD_BITS 5 // room for 16 keywords, the table stays at most half full
+
+/*
+Perfect hash of a keyword table, built by the lexer: no two keywords share a
+slot, so an identifier can only be the keyword in its slot.
+*/
+typedef struct KeywordTable {
+        hash_t seed;
+        struct {
+                const char* source; // NULL for an empty slot
+                unsigned int length;
+                TokenType type;
+        } slots[1 << KEYWORD_BITS];
+} KeywordTable;
+
 #endif /* end of include guard: keywords_h */
@@ -7,16 +7,54 @@
 #include "identifiers_record.h"
 #include "keywords.h"
 
+/*
+The lexer works on the source in memory: a file is read whole, a terminal a
+line at a time. Tokens are slices of that memory, kept until the lexer is
+deleted; only identifiers are copied, once, into the record.
+Tokens only know their offset in the source: lines and columns are counted
+from the source when an error needs them.
+Parsers take their tokens from a ring, that the lexer fills in batches.
+*/
+
+#define LOOKAHEAD 32 // tokens in the ring, a power of 2
+
 typedef struct lexer_info {
-        const Keyword* keywords;
-        FILE* file;
-        IdentifiersRecord* record;
-        Localization pos;
+        KeywordTable keywords;
+        FILE* file; // where more source comes from, NULL if there is none
+        IdentifiersRecord record;
+        struct SourceChunk* chunks; // all the source read so far, the current chunk first
+        const char* cursor; // next char to lex, in the current chunk
+        const char* end; // of the current chunk, where a NUL stands
+        struct LineStart* lines; // where each line starts, indexed up to <indexed> only when locate() is called
+        size_t nb_lines, lines_capacity;
+        SourceOffset indexed;
+        Token ahead[LOOKAHEAD]; // lexed, not consumed yet
+        unsigned int first_ahead, nb_ahead;
 } lexer_info;
 
+// keywords: NULL-terminated
 void mk_lexer_info(lexer_info *const lxinfo, FILE* file, const Keyword* keywords);
 void del_lexer_info(lexer_info *const lxinfo);
+// lexes a copy of <source> from its start, the tokens lexed so far stay valid
+void restart_lexer(lexer_info *const lxinfo, const char* source, const size_t len);
+
+Token lex(lexer_info *const state);
+// makes sure that <count> tokens are in the ring, <count> <= LOOKAHEAD
+void lex_ahead(lexer_info *const lxinfo, const unsigned int count);
+
+// the token <k> places after the next one, without consuming anything; k < LOOKAHEAD
+static inline const Token* peek_token(lexer_info *const lxinfo, const unsigned int k) {
+        if (k >= lxinfo->nb_ahead) lex_ahead(lxinfo, k+1);
+        return &(lxinfo->ahead[(lxinfo->first_ahead + k) & (LOOKAHEAD-1)]);
+}
+static inline Token next_token(lexer_info *const lxinfo) {
+        const Token token = *peek_token(lxinfo, 0);
+        lxinfo->first_ahead = (lxinfo->first_ahead + 1) & (LOOKAHEAD-1);
+        lxinfo->nb_ahead--;
+        return token;
+}
 
-LocalizedToken lex(lexer_info *const state);
+// the line and column of a token that starts at <offset>, counted from the start of its source
+Localization locate(lexer_info *const lxinfo, const SourceOffset offset);
 
 #endif
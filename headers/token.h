@@ -1,6 +1,8 @@
 #ifndef token_h
 #define token_h
 
+#include <stdint.h>
+
 typedef enum {
         TOKEN_IADD,
         TOKEN_ISUB,
@@ -51,10 +53,16 @@ typedef enum {
         TOKEN_EOF, // please don't put new token types below here
 } TokenType;
 
+// where a token starts, in bytes from the start of all the source a lexer read (4 GiB at most); see locate() in lexer.h
+typedef uint32_t SourceOffset;
+
+#define MAX_TOKEN_LENGTH ((1u << 24) - 1) // bytes, so that the length and the type share a word
+
 typedef struct Token {
         char* source;
-        unsigned int length;
-        TokenType type;
+        unsigned int length : 24;
+        TokenType type : 8;
+        SourceOffset offset;
 } Token;
 
 typedef struct Localization {
@@ -62,9 +70,4 @@ typedef struct Localization {
         unsigned int column;
 } Localization;
 
-typedef struct LocalizedToken {
-        Localization pos;
-        Token tok;
-} LocalizedToken;
-
 #endif
@@ -0,0 +1,75 @@
+#include <stdlib.h>
+#include <stddef.h>
+
+#include "arena.h"
+
+#define CHUNK_SIZE (64*1024)
+#define ALIGNMENT (_Alignof(max_align_t))
+
+struct ArenaChunk {
+        ArenaChunk* next;
+        size_t size;
+        size_t used;
+        max_align_t data[];
+};
+
+static ArenaChunk* new_chunk(const size_t size, ArenaChunk *const next) {
+        LOG("New arena chunk of %lu bytes", size);
+        ArenaChunk *const chunk = malloc(offsetof(ArenaChunk, data) + size);
+        chunk->next = next;
+        chunk->size = size;
+        chunk->used = 0;
+        return chunk;
+}
+
+void mk_arena(Arena *const arena) {
+        arena->chunks = NULL;
+}
+void del_arena(Arena *const arena) {
+        ArenaChunk* chunk = arena->chunks;
+        while (chunk != NULL) {
+                ArenaChunk *const next = chunk->next;
+                free(chunk);
+                chunk = next;
+        }
+        arena->chunks = NULL;
+}
+
+void* arena_alloc(Arena *const arena, size_t size) {
+        size = (size + ALIGNMENT-1) & ~(ALIGNMENT-1);
+
+        ArenaChunk* chunk = arena->chunks;
+        if (chunk == NULL || chunk->size - chunk->used < size) {
+                if (size > CHUNK_SIZE/4) {
+                        // big enough to get its own chunk, behind the current one so that we keep filling it
+                        chunk = new_chunk(size, chunk ? chunk->next : NULL);
+                        if (arena->chunks == NULL) arena->chunks = chunk;
+                        else arena->chunks->next = chunk;
+                }
+                else chunk = arena->chunks = new_chunk(CHUNK_SIZE, chunk);
+        }
+
+        void *const ptr = (char*) chunk->data + chunk->used;
+        chunk->used += size;
+        return ptr;
+}
+
+void arena_reset(Arena *const arena) {
+        // keep a single regular chunk
+        ArenaChunk* kept = NULL;
+        ArenaChunk* chunk = arena->chunks;
+        while (chunk != NULL) {
+                ArenaChunk *const next = chunk->next;
+                if (kept == NULL && chunk->size == CHUNK_SIZE) kept = chunk;
+                else free(chunk);
+                chunk = next;
+        }
+        if (kept != NULL) {
+                kept->next = NULL;
+                kept->used = 0;
+        }
+        arena->chunks = kept;
+}
+
+#undef CHUNK_SIZE
+#undef ALIGNMENT
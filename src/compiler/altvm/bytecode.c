@@ -14,6 +14,7 @@ CompiledProgram* createProgram(void) {
         return ret;
 }
 void freeProgram(CompiledProgram* pgm) {
+        if (pgm == NULL) return; // like free(), get_bytecode() leaves NULL behind
         free(pgm->comput_arr);
         free(pgm);
 }
@@ -62,12 +63,22 @@ static CompiledProgram* ensure_computarr(CompiledProgram* ptr) {
         return ptr;
 }
 
+static CompiledProgram* next_pair(CompiledProgram* program) {
+        // the array holds BF_MAX_RUN pairs, the current one included
+        if (program->comput_arr->len < BF_MAX_RUN - 1) program->comput_arr->len++;
+        else {
+                program = ensure_no_computarr(program);
+                program->comput_arr = calloc(sizeof(RawComputationArray), 1);
+        }
+        return program;
+}
+
 CompiledProgram* emitLeftRight(CompiledProgram* program, ssize_t amount) {
         program = ensure_computarr(program);
 
-        RawComputationArray *const arr = program->comput_arr;
+        if (program->comput_arr->bytecode[program->comput_arr->len][1]) program = next_pair(program);
 
-        if (arr->bytecode[arr->len][1]) arr->len++;
+        RawComputationArray *const arr = program->comput_arr;
 
         int8_t already_there = arr->bytecode[arr->len][0];
         if (already_there + amount >= INT8_MIN
@@ -78,13 +89,13 @@ CompiledProgram* emitLeftRight(CompiledProgram* program, ssize_t amount) {
 
         if (amount > 0) {
                 amount -= INT8_MAX - already_there;
-                arr->bytecode[arr->len++][0] = INT8_MAX;
+                arr->bytecode[arr->len][0] = INT8_MAX;
         }
         else { // if (amount <= 0)
-                amount += INT8_MIN + already_there;
-                arr->bytecode[arr->len++][0] = INT8_MIN;
+                amount -= INT8_MIN - already_there;
+                arr->bytecode[arr->len][0] = INT8_MIN;
         }
-        return emitLeftRight(program, amount);
+        return emitLeftRight(next_pair(program), amount);
 }
 CompiledProgram* emitPlusMinus(CompiledProgram* program, ssize_t amount) {
         program = ensure_computarr(program);
@@ -100,13 +111,13 @@ CompiledProgram* emitPlusMinus(CompiledProgram* program, ssize_t amount) {
 
         if (amount > 0) {
                 amount -= INT8_MAX - already_there;
-                arr->bytecode[arr->len++][1] = INT8_MAX;
+                arr->bytecode[arr->len][1] = INT8_MAX;
         }
         else { // if (amount <= 0)
-                amount += INT8_MIN + already_there;
-                arr->bytecode[arr->len++][1] = INT8_MIN;
+                amount -= INT8_MIN - already_there;
+                arr->bytecode[arr->len][1] = INT8_MIN;
         }
-        return emitPlusMinus(program, amount);
+        return emitPlusMinus(next_pair(program), amount);
 }
 CompiledProgram* emitIn(CompiledProgram* program) {
         program = ensure_no_computarr(program);
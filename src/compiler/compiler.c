@@ -69,7 +69,7 @@ static int compileBlock(compiler_info *const state, const Node* node) {
 }
 static int compileDeclaration(compiler_info *const state, const Node* node) {
         Variable v;
-        v.name = node->operands[0].nd->token.tok.source;
+        v.name = node->operands[0].nd->token.source;
         v.val = BF_allocate(state, node->type);
 
         if (node->operands[1].nd != NULL) {
@@ -156,20 +156,20 @@ static int compileWhile(compiler_info *const state, const Node* node) {
 }
 
 static int compile_iadd(compiler_info *const state, const Node* node) {
-        const Variable* v = getVariable(state, node->operands[0].nd->token.tok.source);
+        const Variable* v = getVariable(state, node->operands[0].nd->token.source);
         return compile_expression(state, node->operands[1].nd, (Target) {.pos=v->val.pos, .weight=1});
 }
 static int compile_isub(compiler_info *const state, const Node* node) {
-        const Variable* v = getVariable(state, node->operands[0].nd->token.tok.source);
+        const Variable* v = getVariable(state, node->operands[0].nd->token.source);
         return compile_expression(state, node->operands[1].nd, (Target) {.pos=v->val.pos, .weight=-1});
 }
 static int compile_imul(compiler_info *const state, const Node* node) {
         Value temp;
         Variable* v;
         if (node->operands[1].nd->operator == OP_INT) {
-                v = getVariable(state, node->operands[0].nd->token.tok.source);
+                v = getVariable(state, node->operands[0].nd->token.source);
                 temp = BF_allocate(state, v->val.type);
-                transfer(state, v->val.pos, 1, &((Target){.pos=temp.pos, .weight=atoi(node->operands[1].nd->token.tok.source)}));
+                transfer(state, v->val.pos, 1, &((Target){.pos=temp.pos, .weight=atoi(node->operands[1].nd->token.source)}));
         }
         else {
                 const Value multiplier = BF_allocate(state, node->operands[1].nd->type);
@@ -181,7 +181,7 @@ static int compile_imul(compiler_info *const state, const Node* node) {
                 // important: get the variable _after_ evaluating the right operand
                 // if the code is linear and the variable is referenced in the right operand,
                 // it might get moved as a side-effect.
-                v = getVariable(state, node->operands[0].nd->token.tok.source);
+                v = getVariable(state, node->operands[0].nd->token.source);
                 temp = BF_allocate(state, v->val.type);
 
                 runtime_mul_int(state, (Target){.pos=temp.pos, .weight=1}, v->val.pos, multiplier.pos);
@@ -199,7 +199,7 @@ static int compile_imul(compiler_info *const state, const Node* node) {
         return 1;
 }
 static int compile_affect(compiler_info *const state, const Node* node) {
-        const Variable* v = getVariable(state, node->operands[0].nd->token.tok.source);
+        const Variable* v = getVariable(state, node->operands[0].nd->token.source);
 
         const Value temp = BF_allocate(state, v->val.type);
         if (!compile_expression(state, node->operands[1].nd, (Target) {.pos=temp.pos, .weight=1})) {
@@ -225,7 +225,7 @@ static int compile_affect(compiler_info *const state, const Node* node) {
 
 static int compile_literal_int(compiler_info *const state, const Node* node, const Target target) {
         seekpos(state, target.pos);
-        const ssize_t value = atoi(node->token.tok.source)*target.weight;
+        const ssize_t value = atoi(node->token.source)*target.weight;
         if (value > 0) EMIT_PLUS(state, value);
         else EMIT_MINUS(state, -value);
         return 1;
@@ -233,7 +233,7 @@ static int compile_literal_int(compiler_info *const state, const Node* node, con
 static int compile_variable(compiler_info *const state, const Node* node, const Target target) {
         if (target.weight == 0) return 1;
 
-        Variable *const v = getVariable(state, node->token.tok.source);
+        Variable *const v = getVariable(state, node->token.source);
         Value copy = BF_allocate(state, v->val.type);
         const Target targets[] = {
                 target,
@@ -269,7 +269,7 @@ static int compile_binary_minus(compiler_info *const state, const Node* node, co
         && compile_expression(state, node->operands[1].nd, (Target) {.pos=target.pos, .weight=-target.weight});
 }
 static int compile_call(compiler_info *const state, const Node* node, const Target target) {
-        BuiltinFunctionHandler called = getVariable(state, node->operands[1].nd->token.tok.source)->func->handler;
+        BuiltinFunctionHandler called = getVariable(state, node->operands[1].nd->token.source)->func->handler;
 
         return called(state, &(node->operands[2].nd), target);
 }
@@ -288,8 +288,8 @@ static int compile_multiply(compiler_info *const state, const Node* node, const
                         // we can compute that at compile-time
                         seekpos(state, target.pos);
                         EMIT_PLUS(state,
-                                 atoi(opA->token.tok.source)
-                                *atoi(opB->token.tok.source)
+                                 atoi(opA->token.source)
+                                *atoi(opB->token.source)
                         );
                         return 1;
                 }
@@ -297,14 +297,14 @@ static int compile_multiply(compiler_info *const state, const Node* node, const
                         // multiply a literal with whatever
                         // we just have to adjut the target's weight
                         return compile_expression(state, opB,
-                        (Target) {.pos=target.pos, .weight=target.weight*atoi(opA->token.tok.source)}
+                        (Target) {.pos=target.pos, .weight=target.weight*atoi(opA->token.source)}
                 );
         }
         else {
                 if (opB->operator == OP_INT)
                         // multiply whatever with a literal
                         // we just have to adjut the target's weight
-                        return compile_expression(state, opA, (Target) {.pos=target.pos, .weight=target.weight*atoi(opB->token.tok.source)}
+                        return compile_expression(state, opA, (Target) {.pos=target.pos, .weight=target.weight*atoi(opB->token.source)}
                         );
                 else {
                         // general case, basically two nested `transfer`s
@@ -400,8 +400,9 @@ static int _compile_statement(compiler_info *const state, const Node* node) {
 }
 int compile_statement(compiler_info *const state) {
         Node* node = parse_statement(&(state->prsinfo));
-        if (node == NULL) return 0;
-        else return _compile_statement(state, node);
+        const int status = (node != NULL) && _compile_statement(state, node);
+        release_nodes(&(state->prsinfo));
+        return status;
 }
 
 
@@ -409,7 +410,7 @@ int compile_statement(compiler_info *const state) {
 
 static int builtin_print_int(compiler_info *const state, const struct Node* arg) {
         if (arg->operator == OP_VARIABLE) {
-                Value val = getVariable(state, arg->token.tok.source)->val;
+                Value val = getVariable(state, arg->token.source)->val;
                 seekpos(state, val.pos);
                 EMIT_OUTPUT(state);
                 return 1;
@@ -439,7 +440,7 @@ static int builtin_print(compiler_info *const state, struct Node *const argv[],
 BuiltinFunction builtins[] = {
         {
                 .handler=builtin_print,
-                .name="print", // don't forget to internalize this (and therefore strdup' it)
+                .name="print", // don't forget to internalize this
                 .arity=1,
                 .returnType=TYPE_VOID
         }
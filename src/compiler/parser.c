@@ -11,7 +11,7 @@
 #include "error.h"
 #include "compiler/builtins.h"
 
-#define ALLOCATE_SIMPLE_NODE(operator) (allocateNode(nb_operands[operator]))
+#define ALLOCATE_SIMPLE_NODE(operator) (allocateNode(state, nb_operands[operator]))
 
 typedef enum Precedence {
         PREC_NONE = 1,
@@ -103,39 +103,38 @@ static ResolverRecord* grow_record(ResolverRecord* record, const size_t new_size
         return record;
 }
 
-static inline void refresh(parser_info *const prsinfo) {
-        // call to guarantee the last produced token is not stale
-        if (prsinfo->stale) {
-                prsinfo->last_produced = lex(&(prsinfo->lxinfo));
-                prsinfo->stale = 0;
-        }
+static inline const Token* peek(parser_info *const prsinfo) {
+        return peek_token(&(prsinfo->lxinfo), 0);
 }
-static inline LocalizedToken consume(parser_info *const prsinfo) {
-        refresh(prsinfo);
-        prsinfo->stale = 1;
-        return prsinfo->last_produced;
+static inline Token consume(parser_info *const prsinfo) {
+        return next_token(&(prsinfo->lxinfo));
 }
 static inline TokenType getTtype(parser_info *const prsinfo) {
-        refresh(prsinfo);
-        return prsinfo->last_produced.tok.type;
+        return peek(prsinfo)->type;
 }
 
-static Node* allocateNode(const uintptr_t nb_children) {
-        return malloc(offsetof(Node, operands) + sizeof(Node*)*nb_children);
+static Node* allocateNode(parser_info *const prsinfo, const uintptr_t nb_children) {
+        return arena_alloc(&(prsinfo->nodes), offsetof(Node, operands) + sizeof(Node*)*nb_children);
 }
-static Node* reallocateNode(Node* nd, const uintptr_t nb_children) {
-        return realloc(nd, offsetof(Node, operands) + sizeof(Node*)*nb_children);
+static void push_pending(parser_info *const prsinfo, Node *const node) {
+        if (prsinfo->pending_top >= prsinfo->pending_len) {
+                prsinfo->pending_len *= 2;
+                prsinfo->pending = reallocarray(prsinfo->pending, prsinfo->pending_len, sizeof(prsinfo->pending[0]));
+        }
+        prsinfo->pending[prsinfo->pending_top++] = node;
 }
-void freeNode(Node* node) {
-        if (node == NULL) return;
-
-        uintptr_t nb = nb_operands[node->operator];
-        uintptr_t index;
-        if (nb == UINTPTR_MAX) index = 1, nb = node->operands[0].len;
-        else index = 0;
-
-        for (; index<nb; index++) freeNode(node->operands[index].nd);
-        free(node);
+static Node* pop_pending(parser_info *const prsinfo, const size_t mark, const Token token, const Operator operator) {
+        // builds a node of variable arity from the children pushed since <mark>
+        const uintptr_t count = prsinfo->pending_top - mark;
+        Node *const node = allocateNode(prsinfo, count + 1); // add one, for the length of the array
+        *node = (Node) {.token=token, .operator=operator};
+        node->operands[0].len = count;
+        for (uintptr_t i=0; i<count; i++) node->operands[i+1].nd = prsinfo->pending[mark+i];
+        prsinfo->pending_top = mark;
+        return node;
+}
+void release_nodes(parser_info *const prsinfo) {
+        arena_reset(&(prsinfo->nodes));
 }
 
 ResolverRecord* record_variable(ResolverRecord* record, char const* key, size_t arity, RuntimeType type) {
@@ -163,7 +162,6 @@ static RuntimeType resolve_function(const ResolverRecord* record, const char* ke
 }
 
 void mk_parser_info(parser_info *const prsinfo) {
-        prsinfo->stale = 1;
         ResolverRecord* record = mk_record();
 
         for (size_t i = 0; i < nb_builtins; i++) {
@@ -171,20 +169,26 @@ void mk_parser_info(parser_info *const prsinfo) {
         }
 
         prsinfo->resolv = record;
+        mk_arena(&(prsinfo->nodes));
+        prsinfo->pending_len = 16;
+        prsinfo->pending_top = 0;
+        prsinfo->pending = malloc(prsinfo->pending_len*sizeof(prsinfo->pending[0]));
 }
 void del_parser_info(parser_info *const prsinfo) {
         free_record(prsinfo->resolv);
+        del_arena(&(prsinfo->nodes));
+        free(prsinfo->pending);
 }
 
 static inline int is_affectation_target(const Node* node) {
-        return node->token.tok.type == TOKEN_IDENTIFIER;
+        return node->token.type == TOKEN_IDENTIFIER;
 }
 
 static inline Node* semicolon_or_error(parser_info *const state, Node *const stmt) {
         if (getTtype(state) != TOKEN_SEMICOLON) {
-                LocalizedToken tk = state->last_produced;
-                fprintf(stderr, "line %u, column %u, at \"%.*s\": expected ';'.\n", tk.pos.line, tk.pos.column, tk.tok.length, tk.tok.source);
-                freeNode(stmt);
+                Token tk = *peek(state);
+                const Localization pos = locate(&(state->lxinfo), tk.offset);
+                fprintf(stderr, "line %u, column %u, at \"%.*s\": expected ';'.\n", pos.line, pos.column, tk.length, tk.source);
                 return NULL;
         } else {
                 consume(state);
@@ -195,15 +199,16 @@ static inline Node* semicolon_or_error(parser_info *const state, Node *const stm
 // --------------------- prefix parse functions --------------------------------
 
 static Node* prefixParseError(parser_info *const state) {
-        const LocalizedToken tk = state->last_produced;
-        fprintf(stderr, "Parse error at line %u, column %u, at \"%.*s\"\n", tk.pos.line, tk.pos.column, tk.tok.length, tk.tok.source);
+        const Token tk = *peek(state);
+        const Localization pos = locate(&(state->lxinfo), tk.offset);
+        fprintf(stderr, "Parse error at line %u, column %u, at \"%.*s\"\n", pos.line, pos.column, tk.length, tk.source);
         return NULL;
 }
 static Node* unary_plus(parser_info *const state) {
         static const RuntimeType types[LEN_TYPES] = {
                 [TYPE_INT]=TYPE_INT,
         };
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_UNARY);
         if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_UNARY_PLUS);
@@ -215,7 +220,7 @@ static Node* unary_minus(parser_info *const state) {
         static const RuntimeType types[LEN_TYPES] = {
                 [TYPE_INT]=TYPE_INT,
         };
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_UNARY);
         if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_UNARY_MINUS);
@@ -248,7 +253,7 @@ static Node* invert(parser_info *const state) {
                 [TYPE_INT]=TYPE_INT,
                 [TYPE_STR]=TYPE_INT,
         };
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_UNARY);
         if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_INVERT);
@@ -259,9 +264,8 @@ static Node* invert(parser_info *const state) {
 static Node* identifier(parser_info *const state) {
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_VARIABLE);
         *new = (Node) {.token=consume(state), .operator=OP_VARIABLE};
-        if ((new->type = resolve_variable(state->resolv, new->token.tok.source)) == TYPEERROR) {
-                Error(&(new->token), "Can't resolve identifier %s.\n", new->token.tok.source);
-                freeNode(new);
+        if ((new->type = resolve_variable(state->resolv, new->token.source)) == TYPEERROR) {
+                Error(&(new->token), "Can't resolve identifier %s.\n", new->token.source);
                 return NULL;
         }
         return new;
@@ -270,9 +274,8 @@ static Node* identifier(parser_info *const state) {
 // --------------------- infix parse functions ---------------------------------
 
 static Node* infixParseError(parser_info *const state, Node *const root) {
-        const LocalizedToken tk = state->last_produced;
+        const Token tk = *peek(state);
         Error(&tk, "ParseError.\n");
-        freeNode(root);
         return NULL;
 }
 static Node* binary_plus(parser_info *const state, Node *const root) {
@@ -280,12 +283,9 @@ static Node* binary_plus(parser_info *const state, Node *const root) {
                 [TYPE_INT][TYPE_INT]=TYPE_INT,
                 [TYPE_STR][TYPE_STR]=TYPE_INT,
         };
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_ADD);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_SUM);
         *new = (Node) {.token=operator, .operator=OP_SUM, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -296,12 +296,9 @@ static Node* binary_minus(parser_info *const state, Node *const root) {
         static const RuntimeType types[LEN_TYPES][LEN_TYPES] = {
                 [TYPE_INT][TYPE_INT]=TYPE_INT,
         };
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_ADD);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_DIFFERENCE);
         *new = (Node) {.token=operator, .operator=OP_DIFFERENCE, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -315,12 +312,9 @@ static Node* binary_star(parser_info *const state, Node *const root) {
                 [TYPE_STR][TYPE_INT]=TYPE_INT,
 
         };
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_MUL);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_PRODUCT);
         *new = (Node) {.token=operator, .operator=OP_PRODUCT, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -331,12 +325,9 @@ static Node* binary_slash(parser_info *const state, Node *const root) {
         static const RuntimeType types[LEN_TYPES][LEN_TYPES] = {
                 [TYPE_INT][TYPE_INT]=TYPE_INT,
         };
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_MUL);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_DIVISION);
         *new = (Node) {.token=operator, .operator=OP_DIVISION, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -348,12 +339,9 @@ static Node* binary_and(parser_info *const state, Node *const root) {
                 [TYPE_INT][TYPE_INT]=TYPE_INT,
                 [TYPE_STR][TYPE_STR]=TYPE_STR,
         };
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_AND);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_AND);
         *new = (Node) {.token=operator, .operator=OP_AND, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -365,12 +353,9 @@ static Node* binary_or(parser_info *const state, Node *const root) {
                 [TYPE_INT][TYPE_INT]=TYPE_INT,
                 [TYPE_STR][TYPE_STR]=TYPE_STR,
         };
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_OR);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_OR);
         *new = (Node) {.token=operator, .operator=OP_OR, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -382,12 +367,9 @@ static Node* lt(parser_info *const state, Node *const root) {
                 [TYPE_INT][TYPE_INT]=TYPE_INT,
                 [TYPE_STR][TYPE_STR]=TYPE_INT,
         };
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_COMPARISON);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_LT);
         *new = (Node) {.token=operator, .operator=OP_LT, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -399,12 +381,9 @@ static Node* le(parser_info *const state, Node *const root) {
                 [TYPE_INT][TYPE_INT]=TYPE_INT,
                 [TYPE_STR][TYPE_STR]=TYPE_INT,
         };
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_COMPARISON);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_LE);
         *new = (Node) {.token=operator, .operator=OP_LE, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -417,9 +396,8 @@ static Node* gt(parser_info *const state, Node *const root) {
                 [TYPE_STR][TYPE_STR]=TYPE_INT,
         };
         // > is implemented as !(<=)
-        refresh(state);
         // not how we DON'T consume the token; `le` will do it
-        const LocalizedToken operator = state->last_produced;
+        const Token operator = *peek(state);
         Node* operand = le(state, root);
         if (operand == NULL) return NULL;
 
@@ -434,9 +412,8 @@ static Node* ge(parser_info *const state, Node *const root) {
                 [TYPE_STR][TYPE_STR]=TYPE_INT,
         };
         // >= is implemented as !(<)
-        refresh(state);
         // not how we DON'T consume the token; `lt` will do it
-        const LocalizedToken operator = state->last_produced;
+        const Token operator = *peek(state);
         Node* operand = lt(state, root);
         if (operand == NULL) return NULL;
 
@@ -450,12 +427,9 @@ static Node* ne(parser_info *const state, Node *const root) {
                 [TYPE_INT][TYPE_INT]=TYPE_INT,
                 [TYPE_STR][TYPE_STR]=TYPE_INT,
         };
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_COMPARISON);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_NE);
         *new = (Node) {.token=operator, .operator=OP_NE, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -468,9 +442,8 @@ static Node* eq(parser_info *const state, Node *const root) {
                 [TYPE_STR][TYPE_STR]=TYPE_INT,
         };
         // == is implemented as !(!=)
-        refresh(state);
         // not how we DON'T consume the token; `eq` will do it
-        const LocalizedToken operator = state->last_produced;
+        const Token operator = *peek(state);
         Node* operand = ne(state, root);
         if (operand == NULL) return NULL;
 
@@ -486,12 +459,9 @@ static Node* affect(parser_info *const state, Node *const root) {
         };
         if (root->operator != OP_VARIABLE) return infixParseError(state, root);
 
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_NONE);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_AFFECT);
         *new = (Node) {.token=operator, .operator=OP_AFFECT, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -500,31 +470,29 @@ static Node* affect(parser_info *const state, Node *const root) {
 }
 static Node* call(parser_info *const state, Node *const root) {
         // [count, fnode, argnode...]
-        uintptr_t count = 1; // function node
-        Node* new = allocateNode(count + 1);
-
-        new->token = consume(state);
-        new->operator = OP_CALL;
-        new->operands[1].nd = root;
+        const size_t mark = state->pending_top;
+        const Token token = consume(state);
+        push_pending(state, root);
 
         while (getTtype(state) != TOKEN_PCLOSE) {
                 Node* arg = parseExpression(state, PREC_NONE);
                 if (arg == NULL) {
-                        new->operands[0].len = count;
-                        freeNode(new);
+                        state->pending_top = mark;
                         return NULL;
                 }
-                new = reallocateNode(new, ++count+1);
-                new->operands[count].nd = arg;
+                push_pending(state, arg);
 
                 if (getTtype(state) == TOKEN_COMMA) consume(state);
-                else if (getTtype(state) != TOKEN_PCLOSE) return infixParseError(state, new);
+                else if (getTtype(state) != TOKEN_PCLOSE) {
+                        state->pending_top = mark;
+                        return infixParseError(state, root);
+                }
         }
         consume(state);
-        new->operands[0].len = count;
-        if ((new->type = resolve_function(state->resolv, new->operands[1].nd->token.tok.source, count-1)) == TYPEERROR) {
-                Error(&(new->token), "TypeError : %s is not callable.\n", new->operands[1].nd->token.tok.source);
-                freeNode(new);
+        Node *const new = pop_pending(state, mark, token, OP_CALL);
+        const uintptr_t count = new->operands[0].len;
+        if ((new->type = resolve_function(state->resolv, new->operands[1].nd->token.source, count-1)) == TYPEERROR) {
+                Error(&(new->token), "TypeError : %s is not callable.\n", new->operands[1].nd->token.source);
                 return NULL;
         }
         return new;
@@ -537,12 +505,9 @@ static Node* iadd(parser_info *const state, Node *const root) {
         };
         if (root->operator != OP_VARIABLE) return infixParseError(state, root);
 
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_NONE);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_IADD);
         *new = (Node) {.token=operator, .operator=OP_IADD, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -555,12 +520,9 @@ static Node* isub(parser_info *const state, Node *const root) {
         };
         if (root->operator != OP_VARIABLE) return infixParseError(state, root);
 
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_NONE);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_ISUB);
         *new = (Node) {.token=operator, .operator=OP_ISUB, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -575,12 +537,9 @@ static Node* imul(parser_info *const state, Node *const root) {
         };
         if (root->operator != OP_VARIABLE) return infixParseError(state, root);
 
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_NONE);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_IMUL);
         *new = (Node) {.token=operator, .operator=OP_IMUL, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -593,12 +552,9 @@ static Node* idiv(parser_info *const state, Node *const root) {
         };
         if (root->operator != OP_VARIABLE) return infixParseError(state, root);
 
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_NONE);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_IDIV);
         *new = (Node) {.token=operator, .operator=OP_IDIV, .type=types[root->type][operand->type]};
         new->operands[0].nd = root;
@@ -703,18 +659,16 @@ static Node* declare_statement(parser_info *const state) {
                 consume(state);
                 new->operands[1].nd = parseExpression(state, PREC_NONE);
                 if (new->operands[1].nd == NULL){
-                        freeNode(new);
                         return NULL;
                 }
                 if (new->operands[1].nd->type != new->type) {
                         Error(&(new->token), "TypeError: type mismatch at declaration.\n");
-                        freeNode(new);
                         return NULL;
                 }
         }
 
         if ((new = semicolon_or_error(state, new)) != NULL) {
-                state->resolv = record_variable(state->resolv, new->operands[0].nd->token.tok.source, SIZE_MAX, new->type);
+                state->resolv = record_variable(state->resolv, new->operands[0].nd->token.source, SIZE_MAX, new->type);
         }
 
         return new;
@@ -722,25 +676,21 @@ static Node* declare_statement(parser_info *const state) {
 
 static Node* block_statement(parser_info *const state) {
         const size_t resolv_size = state->resolv->len;
-        uintptr_t nb_children = 0;
-        Node* stmt = allocateNode(nb_children + 1); // add one, for the length of the array
-        stmt->token = consume(state);
-        stmt->operator = OP_BLOCK;
-        stmt->type=TYPE_VOID;
+        const size_t mark = state->pending_top;
+        const Token token = consume(state);
         while (getTtype(state) != TOKEN_BCLOSE) {
                 Node* substmt = parse_statement(state);
                 if (substmt == NULL) {
-                        stmt->operands[0].len = nb_children;
-                        freeNode(stmt);
+                        state->pending_top = mark;
                         state->resolv->len = resolv_size;
                         return NULL;
                 }
-                stmt = reallocateNode(stmt, ++nb_children+1);
-                stmt->operands[nb_children].nd = substmt;
+                push_pending(state, substmt);
         }
-        stmt->operands[0].len = nb_children;
         consume(state);
         state->resolv->len = resolv_size;
+        Node *const stmt = pop_pending(state, mark, token, OP_BLOCK);
+        stmt->type = TYPE_VOID;
         return stmt;
 }
 
@@ -758,24 +708,15 @@ static Node* if_statement(parser_info *const state) {
         new->operator = OP_IFELSE;
         new->type = TYPE_VOID;
         new->operands[0].nd = parseExpression(state, PREC_NONE);
-        if (new->operands[0].nd == NULL) {
-                freeNode(new);
-                return NULL;
-        }
+        if (new->operands[0].nd == NULL) return NULL;
         if (new->operands[0].nd->type != TYPE_INT) {
                 Error(&(new->operands[0].nd->token), "TypeError: can't cast to boolean.\n");
                 return NULL;
         }
-        if ((new->operands[1].nd = parse_statement(state)) == NULL) {
-                freeNode(new);
-                return NULL;
-        }
+        if ((new->operands[1].nd = parse_statement(state)) == NULL) return NULL;
         if (getTtype(state) == TOKEN_ELSE) {
                 consume(state);
-                if ((new->operands[2].nd = parse_statement(state)) == NULL) {
-                        freeNode(new);
-                        return NULL;
-                }
+                if ((new->operands[2].nd = parse_statement(state)) == NULL) return NULL;
         }
         return new;
 }
@@ -785,10 +726,7 @@ static Node* dowhile_statement(parser_info *const state) {
         new->token = consume(state);
         new->operator = OP_DOWHILE;
         new->type = TYPE_VOID;
-        if ((new->operands[0].nd = parse_statement(state)) == NULL) {
-                freeNode(new);
-                return NULL;
-        }
+        if ((new->operands[0].nd = parse_statement(state)) == NULL) return NULL;
         if (getTtype(state) != TOKEN_WHILE) {
                 return infixParseError(state, new);
         }
@@ -797,13 +735,9 @@ static Node* dowhile_statement(parser_info *const state) {
 
         new->operands[1].nd = parseExpression(state, PREC_NONE);
 
-        if (new->operands[1].nd == NULL) {
-                freeNode(new);
-                return NULL;
-        }
+        if (new->operands[1].nd == NULL) return NULL;
         if (new->operands[1].nd->type != TYPE_INT) {
                 Error(&(new->operands[1].nd->token), "TypeError: can't cast to boolean.\n");
-                freeNode(new);
                 return NULL;
         }
 
@@ -815,19 +749,12 @@ static Node* while_statement(parser_info *const state) {
         new->token = consume(state);
         new->operator = OP_WHILE;
         new->type = TYPE_VOID;
-        if ((new->operands[0].nd = parseExpression(state, PREC_NONE)) == NULL) {
-                freeNode(new);
-                return NULL;
-        }
+        if ((new->operands[0].nd = parseExpression(state, PREC_NONE)) == NULL) return NULL;
         if (new->operands[0].nd->type != TYPE_INT) {
                 Error(&(new->operands[0].nd->token), "TypeError: can't cast to boolean.\n");
-                freeNode(new);
-                return NULL;
-        }
-        if ((new->operands[1].nd = parse_statement(state)) == NULL) {
-                freeNode(new);
                 return NULL;
         }
+        if ((new->operands[1].nd = parse_statement(state)) == NULL) return NULL;
         return new;
 }
 
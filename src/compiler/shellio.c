@@ -22,12 +22,12 @@ static const Keyword keywords[] = {
 };
 
 static inline void declare_variable(pipeline_state *const pipeline,  BuiltinFunction *const function) {
-        char *const mallocd = internalize(&(pipeline->cmpinfo.prsinfo.lxinfo.record), strdup(function->name), strlen(function->name));
+        char *const name = internalize(&(pipeline->cmpinfo.prsinfo.lxinfo.record), function->name, strlen(function->name));
 
-        Variable v = (Variable) {.name=mallocd, .func=function};
+        Variable v = (Variable) {.name=name, .func=function};
 
         addVariable(&(pipeline->cmpinfo), v);
-        pipeline->cmpinfo.prsinfo.resolv = record_variable(pipeline->cmpinfo.prsinfo.resolv, mallocd, function->arity, function->returnType);
+        pipeline->cmpinfo.prsinfo.resolv = record_variable(pipeline->cmpinfo.prsinfo.resolv, name, function->arity, function->returnType);
 }
 
 CompiledProgram* input_highlevel(FILE* file) {
@@ -1,20 +1,63 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdarg.h>
 
 #include "error.h"
+#include "lexer.h"
 
-void Error(const LocalizedToken* where, const char* message, ...) {
+static _Thread_local Reporter reporter = {.report=NULL};
+static _Thread_local lexer_info* source = NULL;
+
+void set_reporter(const Reporter new) {
+        reporter = new;
+}
+
+void set_error_source(lexer_info* lxinfo) {
+        source = lxinfo;
+}
+void drop_error_source(const lexer_info* lxinfo) {
+        if (source == lxinfo) source = NULL;
+}
+Localization source_position(const SourceOffset offset) {
+        if (source == NULL) return (Localization) {.line=0, .column=0};
+        return locate(source, offset);
+}
+
+static void report(const int is_error, const Token* where, const char* message, va_list params) {
+        const Localization pos = source_position(where->offset);
+        if (reporter.report == NULL) {
+                fflush(stdout); // after the output that came before
+                fprintf(stderr, "%s at line %u, column %u, at `%.*s`: ", is_error ? "Error" : "Warning", pos.line, pos.column, where->length, where->source);
+                vfprintf(stderr, message, params);
+                return;
+        }
+
+        char buffer[256];
+        va_list copy;
+        va_copy(copy, params);
+        const int len = vsnprintf(buffer, sizeof(buffer), message, copy);
+        va_end(copy);
+        if (len < 0) return;
+        if ((size_t) len < sizeof(buffer)) {
+                reporter.report(reporter.userdata, is_error, where, pos, buffer);
+                return;
+        }
+        char *const text = malloc(len+1);
+        vsnprintf(text, len+1, message, params);
+        reporter.report(reporter.userdata, is_error, where, pos, text);
+        free(text);
+}
+
+void Error(const Token* where, const char* message, ...) {
         va_list params;
         va_start(params, message);
-        fprintf(stderr, "Error at line %u, column %u, at `%s`: ", where->pos.line, where->pos.column, where->tok.source);
-        vfprintf(stderr, message, params);
+        report(1, where, message, params);
         va_end(params);
 }
 
-void Warning(const LocalizedToken* where, const char* message, ...) {
+void Warning(const Token* where, const char* message, ...) {
         va_list params;
         va_start(params, message);
-        fprintf(stderr, "Warning at line %u, column %u, at `%s`: ", where->pos.line, where->pos.column, where->tok.source);
-        vfprintf(stderr, message, params);
+        report(0, where, message, params);
         va_end(params);
 }
@@ -1,6 +1,11 @@
+#include <string.h>
+
 #include "hash.h"
 
-// constants for FNV-1A
+#ifdef HASH_FNV
+
+// FNV-1A; from https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
+
 #ifdef __GNUC__ // GCC defines convenient macros, let's use them!
 
 #ifdef __LP64__ // values for 64-bits arch
@@ -16,29 +21,134 @@
 #define HASH_MUL 0x01000193
 #endif
 
-
-// FNV-1A; from https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
-
-hash_t resume_hashing(char const* string, hash_t hash) {
-        // uint64_t hash = HASH_BASE;
-        for (;*string; string++) {
-                hash ^= *string;
+static inline hash_t resume_hashing(hash_t hash, char const* data, const size_t len) {
+        for (size_t i=0; i<len; i++) {
+                hash ^= data[i];
                 hash *= HASH_MUL;
         }
         return hash;
 }
-hash_t hash_stringn(char const* string, const unsigned short len) {
-        // designed to hash token strings, therefore `unsigned short` instead of `intmax_t`
-        hash_t hash = HASH_BASE;
-        for (unsigned short i=0; i<len; i++) {
-                hash ^= string[i];
-                hash *= HASH_MUL;
-        }
-        return hash;
+
+void hash_start(HashState *const state) {
+        state->hash = HASH_BASE;
 }
-hash_t hash_string(char const* string) {
-        return resume_hashing(string, 0xcbf29ce484222325);
+void hash_update(HashState *const state, char const* data, const size_t len) {
+        state->hash = resume_hashing(state->hash, data, len);
+}
+hash_t hash_finish(const HashState *const state) {
+        return state->hash;
+}
+
+hash_t hash_bytes(char const* data, const size_t len) {
+        return resume_hashing(HASH_BASE, data, len);
 }
 
 #undef HASH_BASE
 #undef HASH_MUL
+
+#else
+
+/*
+After wyhash (https://github.com/wangyi-fudan/wyhash): 16-byte blocks are
+folded into the seed by a 64x64->128 bits multiply, the last 0 to 15 bytes
+are read as two overlapping words. Identifiers are mostly shorter than 16
+bytes, and so take no loop at all.
+*/
+
+#define P0 UINT64_C(0xa0761d6478bd642f)
+#define P1 UINT64_C(0xe7037ed1a0b428db)
+#define BLOCK 16
+
+static inline uint64_t mum(const uint64_t a, const uint64_t b) {
+        // the two halves of the product, xored
+#ifdef __SIZEOF_INT128__
+        const __uint128_t r = (__uint128_t) a * b;
+        return (uint64_t) r ^ (uint64_t) (r >> 64);
+#else
+        const uint64_t ha = a >> 32, la = (uint32_t) a, hb = b >> 32, lb = (uint32_t) b;
+        const uint64_t high = ha*hb, mid0 = ha*lb, mid1 = hb*la, low = la*lb;
+        const uint64_t t = low + (mid0 << 32);
+        const uint64_t lo = t + (mid1 << 32);
+        const uint64_t hi = high + (mid0 >> 32) + (mid1 >> 32) + (t < low) + (lo < t);
+        return lo ^ hi;
+#endif
+}
+
+static inline uint64_t read64(const unsigned char* p) {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v)); // may be unaligned
+        return v;
+}
+static inline uint64_t read32(const unsigned char* p) {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+}
+
+static inline uint64_t mix_block(const uint64_t seed, const unsigned char* block) {
+        return mum(read64(block) ^ P1, read64(block+8) ^ seed);
+}
+
+static inline hash_t mix_tail(const uint64_t seed, const unsigned char* tail, const size_t nb, const uint64_t length) {
+        // nb < BLOCK; from 4 bytes on, the two words overlap as needed to cover the tail
+        uint64_t a, b;
+        if (nb >= 4) {
+                const size_t shift = (nb >> 3) << 2;
+                a = (read32(tail) << 32) | read32(tail + shift);
+                b = (read32(tail + nb - 4) << 32) | read32(tail + nb - 4 - shift);
+        }
+        else if (nb > 0) {
+                a = ((uint64_t) tail[0] << 16) | ((uint64_t) tail[nb >> 1] << 8) | tail[nb - 1];
+                b = 0;
+        }
+        else a = b = 0;
+        return (hash_t) mum(P1 ^ length, mum(a ^ P1, b ^ seed));
+}
+
+void hash_start(HashState *const state) {
+        state->seed = P0;
+        state->length = 0;
+        state->nb_pending = 0;
+}
+void hash_update(HashState *const state, char const* data, size_t len) {
+        const unsigned char* p = (const unsigned char*) data;
+        state->length += len;
+        if (state->nb_pending) {
+                const size_t taken = (len < BLOCK - state->nb_pending) ? len : BLOCK - state->nb_pending;
+                memcpy(state->pending + state->nb_pending, p, taken);
+                state->nb_pending += taken;
+                p += taken;
+                len -= taken;
+                if (state->nb_pending < BLOCK) return;
+                state->seed = mix_block(state->seed, state->pending);
+                state->nb_pending = 0;
+        }
+        for (; len >= BLOCK; p += BLOCK, len -= BLOCK) state->seed = mix_block(state->seed, p);
+        memcpy(state->pending, p, len);
+        state->nb_pending = len;
+}
+hash_t hash_finish(const HashState *const state) {
+        return mix_tail(state->seed, state->pending, state->nb_pending, state->length);
+}
+
+hash_t hash_bytes(char const* data, const size_t len) {
+        const unsigned char* p = (const unsigned char*) data;
+        uint64_t seed = P0;
+        size_t left = len;
+        for (; left >= BLOCK; p += BLOCK, left -= BLOCK) seed = mix_block(seed, p);
+        return mix_tail(seed, p, left, len);
+}
+
+#undef P0
+#undef P1
+#undef BLOCK
+
+#endif
+
+hash_t hash_stringn(char const* string, const size_t len) {
+        // token strings, up to MAX_TOKEN_LENGTH bytes
+        return hash_bytes(string, len);
+}
+hash_t hash_string(char const* string) {
+        return hash_bytes(string, strlen(string));
+}
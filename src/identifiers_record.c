@@ -1,97 +1,116 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "identifiers_record.h"
 
-#define GROW_THRESHHOLD (0.8) // TODO: benchmark this value
+#define GROUP_SIZE 16 // slots
+#define INITIAL_CAPACITY 64 // slots
+#define EMPTY 0x80 // control byte of an empty slot; the others are 7 bits of a hash
 
-static void put_identifier(IdentifiersRecord *const pool, Identifier id) {
-        const size_t mask = pool->len-1;
-        hash_t index = id.hash;
-        for (;
-                pool->pool[mask&index].source != NULL;
-                index++);
-        pool->pool[mask&index] = id;
-        pool->nb_entries++;
+static inline uint8_t control_byte(const hash_t hash) {
+        return hash & 0x7F;
+}
+static inline size_t first_group(const IdentifiersRecord *const record, const hash_t hash) {
+        // the low bits go to the control byte, the group comes from the others
+        return ((hash >> 7) * GROUP_SIZE) & (record->capacity-1);
 }
 
-static IdentifiersRecord* growRecord(IdentifiersRecord* pool) {
-        const size_t new_size = pool->len * 2;
-
-        LOG("Record grows from %lu to %lu entries", pool->len, new_size);
-
-        IdentifiersRecord *new_pool = calloc(offsetof(IdentifiersRecord, pool) + sizeof(Identifier)*new_size, 1);
-        new_pool->len = new_size;
-        for (size_t i=0; i<pool->len; i++) {
-                Identifier id = pool->pool[i];
-                if (id.source != NULL) put_identifier(new_pool, id);
-        }
-        free(pool); // NOT freeRecord, because we want to keep the contents intact
-        return new_pool;
+static inline unsigned int match_group(const uint8_t* group, const uint8_t byte) {
+        // bit i is set if the control byte of slot i is <byte>
+#ifdef __SSE2__
+        const __m128i controls = _mm_loadu_si128((const __m128i*) group);
+        // spread by a multiply: GCC may build _mm_set1_epi8 by storing the byte and loading it back as a word, which stalls
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi32(byte * 0x01010101u)));
+#else
+        unsigned int mask = 0;
+        for (unsigned int i=0; i<GROUP_SIZE; i++) mask |= (unsigned int) (group[i] == byte) << i;
+        return mask;
+#endif
 }
 
-IdentifiersRecord* allocateRecord(void) {
-        IdentifiersRecord *const pool = calloc(offsetof(IdentifiersRecord, pool) + sizeof(Identifier)*1, 1);
-        pool->len = 1;
-        return pool;
+static void allocate_slots(IdentifiersRecord *const record, const size_t capacity) {
+        record->capacity = capacity;
+        record->control = malloc(capacity);
+        memset(record->control, EMPTY, capacity);
+        record->slots = malloc(capacity*sizeof(Identifier));
 }
-void freeRecord(IdentifiersRecord* pool) {
-        for (size_t i=0; i<pool->len; i++) {
-                free(pool->pool[i].source); // either it's a pointer to a malloc'd string, or NULL
+
+static void put_identifier(IdentifiersRecord *const record, const Identifier id) {
+        // <id> isn't in the record yet
+        for (size_t group=first_group(record, id.hash); ; group=(group+GROUP_SIZE) & (record->capacity-1)) {
+                const unsigned int empty = match_group(record->control+group, EMPTY);
+                if (empty) {
+                        const size_t slot = group + __builtin_ctz(empty);
+                        record->control[slot] = control_byte(id.hash);
+                        record->slots[slot] = id;
+                        record->nb_entries++;
+                        return;
+                }
         }
-        free(pool);
 }
 
-/*
-Note: [see also the note in pipeline/lexer.c]
-`internalize` expects to get a — not necessarily null-terminated — malloc'd string.
-In all cases, the record takes ownership of that string.
-If `internalize` deduplicates it, then it frees the string it was passed (the one that doesn't get returned).
-*/
-char* internalize(IdentifiersRecord **const record, char *const string, unsigned short length) {
-        #define BUCKET_FULL(bucket) ((bucket).source != NULL)
-        #define SAME_HASH(bucket, hsh) ((bucket).hash == (hsh))
-        #define SAME_STRING(bucket, s2, l) (strncmp((bucket).source, (s2), (l)) == 0)
-        #define SAME_CONTENT(bucket, hsh, s2, l) (SAME_HASH((bucket), (hsh)) && SAME_STRING((bucket), (s2), (l)))
-
-        #define ADVANCE() (index = (index+1) & mask, (*record)->pool[index]) // careful, modifies local var `index`
-
-        // I'd rather the pool doesn't change size in the middle of the function
-        if ((*record)->len * GROW_THRESHHOLD <= ((*record)->nb_entries+1))
-                *record = growRecord(*record);
-
-        const size_t mask = (*record)->len-1;
-        const hash_t hash = hash_stringn(string, length);
-
-        // Step 1: find wether the string is already internalized.
+static void grow_record(IdentifiersRecord *const record) {
+        // the strings stay where they are, only the slots move
+        uint8_t *const control = record->control;
+        Identifier *const slots = record->slots;
+        const size_t capacity = record->capacity;
 
-        hash_t index = hash;
-        Identifier id;
+        LOG("Record grows from %lu to %lu entries", capacity, capacity*2);
 
-        index = index & mask;
-        id = (*record)->pool[index];
-        while (BUCKET_FULL(id) && !SAME_CONTENT(id, hash, string, length) ) {
-                id = ADVANCE();
+        allocate_slots(record, capacity*2);
+        record->nb_entries = 0;
+        for (size_t i=0; i<capacity; i++) {
+                if (control[i] != EMPTY) put_identifier(record, slots[i]);
         }
+        free(control);
+        free(slots);
+}
 
-        if (BUCKET_FULL(id)) {
-                free(string);
-                return id.source;
-        }
-
-        // Step 2: it's not there, put it in.
-        while (BUCKET_FULL(id)) id = ADVANCE();
-
-        (*record)->pool[mask&index] = (Identifier) {.source=string, .hash=hash};
-        (*record)->nb_entries++;
+void mk_identifiers_record(IdentifiersRecord *const record) {
+        allocate_slots(record, INITIAL_CAPACITY);
+        record->nb_entries = 0;
+        mk_arena(&(record->strings));
+}
+void del_identifiers_record(IdentifiersRecord *const record) {
+        free(record->control);
+        free(record->slots);
+        del_arena(&(record->strings));
+}
 
-        return string;
+/*
+Note: [see also the note in lexer.c]
+`internalize` gets a — not necessarily null-terminated — slice of a buffer it
+doesn't own, typically the source code. Only new strings are copied, with a
+null terminator.
+*/
+char* internalize(IdentifiersRecord *const record, const char* string, const size_t length) {
+        return internalize_hashed(record, string, length, hash_stringn(string, length));
+}
+char* internalize_hashed(IdentifiersRecord *const record, const char* string, const size_t length, const hash_t hash) {
+        // at most 7/8 full, so that the probing always meets an empty slot soon
+        if (8*(record->nb_entries+1) > 7*record->capacity) grow_record(record);
+
+        const uint8_t byte = control_byte(hash);
+        for (size_t group=first_group(record, hash); ; group=(group+GROUP_SIZE) & (record->capacity-1)) {
+                for (unsigned int candidates=match_group(record->control+group, byte); candidates; candidates&=candidates-1) {
+                        const Identifier *const id = &(record->slots[group + __builtin_ctz(candidates)]);
+                        if (id->hash == hash && id->length == length && !memcmp(id->source, string, length)) return id->source;
+                }
+                if (match_group(record->control+group, EMPTY)) break;
+        }
 
-        #undef BUCKET_FULL
-        #undef SAME_HASH
-        #undef SAME_STRING
-        #undef SAME_CONTENT
+        // it's not there, put a copy in
+        char *const copy = arena_alloc(&(record->strings), length+1);
+        memcpy(copy, string, length);
+        copy[length] = '\0';
+        put_identifier(record, (Identifier) {.source=copy, .hash=hash, .length=length});
+        return copy;
 }
 
-#undef GROW_THRESHHOLD
+#undef GROUP_SIZE
+#undef INITIAL_CAPACITY
+#undef EMPTY
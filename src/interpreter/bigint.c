@@ -0,0 +1,377 @@
+#include <stdlib.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "interpreter/bigint.h"
+#include "interpreter/object.h"
+#include "interpreter/string.h"
+
+#define KARATSUBA_THRESHOLD 32 // limbs; smaller products are done the schoolbook way
+#define CHUNK_DIGITS 19 // decimal digits that always fit in a limb
+#define CHUNK_BASE UINT64_C(10000000000000000000) // 10^CHUNK_DIGITS
+
+typedef uint64_t limb_t;
+typedef unsigned __int128 dlimb_t;
+
+_Static_assert(sizeof(intmax_t) == sizeof(limb_t), "an int must fit in a single limb");
+
+typedef struct View {
+        // an int or a bigint, seen as a sign and a magnitude
+        const limb_t* limbs;
+        size_t len;
+        int negative;
+        limb_t small; // storage for the magnitude of an int
+} View;
+
+static void view_of(const Object* obj, View *const view) {
+        if (OBJ_TYPE(*obj) == TYPE_BIGINT) {
+                const ObjBigInt *const big = AS_BIGINT(*obj);
+                view->limbs = big->limbs;
+                view->len = big->len;
+                view->negative = big->negative;
+        } else {
+                const intmax_t value = AS_INT(*obj);
+                view->negative = value < 0;
+                view->small = view->negative ? -(limb_t) value : (limb_t) value;
+                view->limbs = &(view->small);
+                view->len = (value != 0);
+        }
+}
+
+static ObjBigInt* allocate_bigint(const size_t len) {
+        // not tracked until normalized
+        ObjBigInt *const big = malloc(offsetof(ObjBigInt, limbs) + sizeof(limb_t)*len);
+        big->len = len;
+        big->negative = 0;
+        return big;
+}
+static Object normalize(ObjBigInt* big) {
+        // takes ownership of <big>
+        const size_t size = offsetof(ObjBigInt, limbs) + sizeof(limb_t)*big->len;
+        while (big->len && big->limbs[big->len-1] == 0) big->len--;
+
+        if (big->len <= 1) {
+                const limb_t magnitude = big->len ? big->limbs[0] : 0;
+                const int negative = big->negative;
+                if (!negative && magnitude <= INTMAX_MAX) {
+                        free(big);
+                        return OBJ_INT((intmax_t) magnitude);
+                }
+                if (negative && magnitude <= (limb_t) INTMAX_MAX + 1) {
+                        free(big);
+                        return OBJ_INT(-(intmax_t) (magnitude - 1) - 1);
+                }
+        }
+
+        gc_track(&(big->gc), GC_BIGINT, size);
+        return OBJ_BIGINT(big);
+}
+void free_bigint(ObjBigInt* big) {
+        free(big);
+}
+
+// ------------------------------ magnitudes -----------------------------------
+
+static int compare_limbs(const limb_t* a, const size_t alen, const limb_t* b, const size_t blen) {
+        // no leading zeros
+        if (alen != blen) return (alen > blen) ? 1 : -1;
+        for (size_t i=alen; i-->0; ) {
+                if (a[i] != b[i]) return (a[i] > b[i]) ? 1 : -1;
+        }
+        return 0;
+}
+static limb_t add_into(limb_t* dst, const size_t dlen, const limb_t* src, const size_t slen) {
+        // dst += src, with slen <= dlen; returns the carry out of dst
+        limb_t carry = 0;
+        size_t i = 0;
+        for (; i<slen; i++) {
+                const dlimb_t sum = (dlimb_t) dst[i] + src[i] + carry;
+                dst[i] = (limb_t) sum;
+                carry = sum >> 64;
+        }
+        for (; carry && i<dlen; i++) carry = (++dst[i] == 0);
+        return carry;
+}
+static void sub_into(limb_t* dst, const size_t dlen, const limb_t* src, const size_t slen) {
+        // dst -= src, with slen <= dlen and src <= dst
+        limb_t borrow = 0;
+        size_t i = 0;
+        for (; i<slen; i++) {
+                const limb_t d = dst[i];
+                dst[i] = d - src[i] - borrow;
+                borrow = (d < src[i]) || (d == src[i] && borrow);
+        }
+        for (; borrow && i<dlen; i++) borrow = (dst[i]-- == 0);
+}
+static limb_t divide_small(limb_t* a, const size_t len, const limb_t divisor) {
+        // a /= divisor; returns the remainder
+        dlimb_t remainder = 0;
+        for (size_t i=len; i-->0; ) {
+                const dlimb_t current = (remainder << 64) | a[i];
+                a[i] = (limb_t) (current / divisor);
+                remainder = current % divisor;
+        }
+        return (limb_t) remainder;
+}
+
+static size_t bit_length(const limb_t* a, const size_t len) {
+        return len ? 64*len - __builtin_clzll(a[len-1]) : 0;
+}
+static void shift_left(limb_t* dst, const size_t dlen, const limb_t* src, const size_t slen, const size_t shift) {
+        // dst[0 .. dlen) = src << shift, which must fit
+        const size_t limbs = shift / 64, bits = shift % 64;
+        memset(dst, 0, sizeof(limb_t)*dlen);
+        for (size_t i=0; i<slen; i++) {
+                dst[i+limbs] |= src[i] << bits;
+                if (bits && src[i] >> (64-bits)) dst[i+limbs+1] |= src[i] >> (64-bits);
+        }
+}
+
+static void multiply(const limb_t* a, size_t alen, const limb_t* b, size_t blen, limb_t* out) {
+        // out[0 .. alen+blen) = a*b; out must not overlap the operands
+        if (alen < blen) {
+                const limb_t* swap = a; a = b; b = swap;
+                const size_t swaplen = alen; alen = blen; blen = swaplen;
+        }
+
+        if (blen < KARATSUBA_THRESHOLD) {
+                memset(out, 0, sizeof(limb_t)*(alen+blen));
+                for (size_t i=0; i<blen; i++) {
+                        limb_t carry = 0;
+                        for (size_t j=0; j<alen; j++) {
+                                const dlimb_t product = (dlimb_t) b[i]*a[j] + out[i+j] + carry;
+                                out[i+j] = (limb_t) product;
+                                carry = product >> 64;
+                        }
+                        out[i+alen] = carry;
+                }
+                return;
+        }
+
+        if (2*blen <= alen) {
+                // lopsided: slice the longer operand, so that each product is balanced
+                limb_t *const slice = malloc(sizeof(limb_t)*2*blen);
+                memset(out, 0, sizeof(limb_t)*(alen+blen));
+                for (size_t offset=0; offset<alen; offset+=blen) {
+                        const size_t len = (alen-offset < blen) ? alen-offset : blen;
+                        multiply(a+offset, len, b, blen, slice);
+                        add_into(out+offset, alen+blen-offset, slice, len+blen);
+                }
+                free(slice);
+                return;
+        }
+
+        // Karatsuba: a = a1.B^m + a0, b = b1.B^m + b0
+        // a*b = z2.B^2m + ((a0+a1)(b0+b1) - z2 - z0).B^m + z0
+        const size_t m = (alen+1)/2;
+        const size_t a1len = alen-m, b1len = blen-m;
+        limb_t *const z0 = out;
+        limb_t *const z2 = out + 2*m;
+        multiply(a, m, b, m, z0);
+        multiply(a+m, a1len, b+m, b1len, z2);
+
+        limb_t *const sums = malloc(sizeof(limb_t)*(2*(m+1) + 2*(m+1)));
+        limb_t *const sa = sums;
+        limb_t *const sb = sums + (m+1);
+        limb_t *const z1 = sums + 2*(m+1);
+        memcpy(sa, a, sizeof(limb_t)*m);
+        sa[m] = add_into(sa, m, a+m, a1len);
+        memcpy(sb, b, sizeof(limb_t)*m);
+        sb[m] = add_into(sb, m, b+m, b1len);
+
+        multiply(sa, m+1, sb, m+1, z1);
+        sub_into(z1, 2*(m+1), z0, 2*m);
+        sub_into(z1, 2*(m+1), z2, a1len+b1len);
+
+        // what's left of z1 fits in the upper part of the result
+        const size_t room = alen+blen-m;
+        add_into(out+m, room, z1, (2*(m+1) < room) ? 2*(m+1) : room);
+        free(sums);
+}
+
+// ------------------------------ operations -----------------------------------
+
+static Object add_views(const View* a, const View* b, const int b_negative) {
+        if (a->negative == b_negative) {
+                const View *const longer = (a->len >= b->len) ? a : b;
+                const View *const shorter = (a->len >= b->len) ? b : a;
+                ObjBigInt *const sum = allocate_bigint(longer->len+1);
+                memcpy(sum->limbs, longer->limbs, sizeof(limb_t)*longer->len);
+                sum->limbs[longer->len] = add_into(sum->limbs, longer->len, shorter->limbs, shorter->len);
+                sum->negative = a->negative;
+                return normalize(sum);
+        }
+
+        // opposite signs: the larger magnitude gives its sign
+        const int order = compare_limbs(a->limbs, a->len, b->limbs, b->len);
+        const View *const larger = (order >= 0) ? a : b;
+        const View *const smaller = (order >= 0) ? b : a;
+        ObjBigInt *const difference = allocate_bigint(larger->len);
+        memcpy(difference->limbs, larger->limbs, sizeof(limb_t)*larger->len);
+        sub_into(difference->limbs, larger->len, smaller->limbs, smaller->len);
+        difference->negative = (order >= 0) ? a->negative : b_negative;
+        return normalize(difference);
+}
+Object bigint_add(const Object a, const Object b) {
+        View va, vb;
+        view_of(&a, &va);
+        view_of(&b, &vb);
+        return add_views(&va, &vb, vb.negative);
+}
+Object bigint_sub(const Object a, const Object b) {
+        View va, vb;
+        view_of(&a, &va);
+        view_of(&b, &vb);
+        return add_views(&va, &vb, !vb.negative);
+}
+Object bigint_mul(const Object a, const Object b) {
+        View va, vb;
+        view_of(&a, &va);
+        view_of(&b, &vb);
+        if (va.len == 0 || vb.len == 0) return OBJ_INT(0);
+
+        ObjBigInt *const product = allocate_bigint(va.len+vb.len);
+        multiply(va.limbs, va.len, vb.limbs, vb.len, product->limbs);
+        product->negative = (va.negative != vb.negative);
+        return normalize(product);
+}
+double bigint_div(const Object a, const Object b) {
+        View va, vb;
+        view_of(&a, &va);
+        view_of(&b, &vb);
+        if (va.len == 0 || vb.len == 0) return bigint_to_double(a) / bigint_to_double(b);
+
+        /*
+        Bit by bit long division of the magnitudes, once aligned on their
+        leading bits: 66 bits of quotient, plus a sticky bit for the remainder,
+        are enough to round to the nearest double.
+        */
+        const size_t alen = bit_length(va.limbs, va.len), blen = bit_length(vb.limbs, vb.len);
+        const size_t len = ((alen > blen) ? alen : blen) / 64 + 2; // room for the remainder doubled
+        limb_t *const remainder = malloc(sizeof(limb_t)*2*len);
+        limb_t *const divisor = remainder + len;
+        shift_left(remainder, len, va.limbs, va.len, (alen < blen) ? blen-alen : 0);
+        shift_left(divisor, len, vb.limbs, vb.len, (alen > blen) ? alen-blen : 0);
+
+        dlimb_t quotient = 0;
+        for (int i=0; i<66; i++) {
+                quotient <<= 1;
+                if (compare_limbs(remainder, len, divisor, len) >= 0) {
+                        sub_into(remainder, len, divisor, len);
+                        quotient |= 1;
+                }
+                for (size_t k=len; k-->1; ) remainder[k] = (remainder[k] << 1) | (remainder[k-1] >> 63);
+                remainder[0] <<= 1;
+        }
+        int sticky = 0;
+        for (size_t k=0; k<len; k++) sticky |= (remainder[k] != 0);
+        free(remainder);
+
+        // a/b = quotient * 2^(alen-blen-65); keep 64 bits, the dropped ones are sticky
+        int exponent = (int) alen - (int) blen - 65;
+        const int drop = (quotient >> 65) ? 2 : 1;
+        sticky |= ((quotient & ((1 << drop) - 1)) != 0);
+        const limb_t top = (limb_t) (quotient >> drop) | sticky;
+        exponent += drop;
+
+        const double magnitude = ldexp((double) top, exponent);
+        return (va.negative != vb.negative) ? -magnitude : magnitude;
+}
+Object bigint_negate(const Object a) {
+        View va;
+        view_of(&a, &va);
+        ObjBigInt *const negated = allocate_bigint(va.len);
+        memcpy(negated->limbs, va.limbs, sizeof(limb_t)*va.len);
+        negated->negative = !va.negative;
+        return normalize(negated);
+}
+int bigint_compare(const Object a, const Object b) {
+        View va, vb;
+        view_of(&a, &va);
+        view_of(&b, &vb);
+        if (va.negative != vb.negative) return va.negative ? -1 : 1;
+        const int order = compare_limbs(va.limbs, va.len, vb.limbs, vb.len);
+        return va.negative ? -order : order;
+}
+
+// ------------------------------ conversions ----------------------------------
+
+double bigint_to_double(const Object a) {
+        View va;
+        view_of(&a, &va);
+        double value = 0;
+        for (size_t i=va.len; i-->0; ) value = value*18446744073709551616.0 + (double) va.limbs[i];
+        return va.negative ? -value : value;
+}
+Object bigint_parse(const char* string, const size_t len) {
+        size_t i = 0;
+        int negative = 0;
+        if (len && (string[0] == '-' || string[0] == '+')) {
+                negative = (string[0] == '-');
+                i++;
+        }
+        if (i == len) return ERROR;
+
+        ObjBigInt *const big = allocate_bigint((len-i)/CHUNK_DIGITS + 2);
+        size_t used = 0;
+        // the first chunk takes the leftover digits, so that the following ones are full
+        size_t chunk_len = (len-i) % CHUNK_DIGITS;
+        if (chunk_len == 0) chunk_len = CHUNK_DIGITS;
+
+        while (i < len) {
+                limb_t chunk = 0, base = 1;
+                for (size_t k=0; k<chunk_len; k++) {
+                        const char c = string[i+k];
+                        if (c < '0' || c > '9') {
+                                free(big);
+                                return ERROR;
+                        }
+                        chunk = chunk*10 + (c-'0');
+                        base *= 10;
+                }
+                // big = big*base + chunk
+                limb_t carry = chunk;
+                for (size_t j=0; j<used; j++) {
+                        const dlimb_t current = (dlimb_t) big->limbs[j]*base + carry;
+                        big->limbs[j] = (limb_t) current;
+                        carry = current >> 64;
+                }
+                if (carry) big->limbs[used++] = carry;
+                i += chunk_len;
+                chunk_len = CHUNK_DIGITS;
+        }
+
+        big->len = used;
+        big->negative = negative;
+        return normalize(big);
+}
+ObjString* bigint_to_string(const ObjBigInt* big) {
+        // quadratic, but only printing pays for it
+        size_t len = big->len;
+        limb_t *const work = malloc(sizeof(limb_t)*len);
+        memcpy(work, big->limbs, sizeof(limb_t)*len);
+        limb_t *const chunks = malloc(sizeof(limb_t)*(2*len+1)); // a limb holds less than 2 chunks
+        size_t nb_chunks = 0;
+        while (len) {
+                chunks[nb_chunks++] = divide_small(work, len, CHUNK_BASE);
+                while (len && work[len-1] == 0) len--;
+        }
+
+        char *const buffer = malloc(nb_chunks*CHUNK_DIGITS + 2);
+        int pos = 0;
+        if (big->negative) buffer[pos++] = '-';
+        pos += sprintf(buffer+pos, "%lu", chunks[nb_chunks-1]);
+        for (size_t i=nb_chunks-1; i-->0; ) pos += sprintf(buffer+pos, "%019lu", chunks[i]);
+
+        ObjString *const string = makeString(buffer, pos);
+        free(buffer);
+        free(chunks);
+        free(work);
+        return string;
+}
+
+#undef KARATSUBA_THRESHOLD
+#undef CHUNK_DIGITS
+#undef CHUNK_BASE
@@ -3,20 +3,52 @@
 #include <stdlib.h>
 
 #include "interpreter/builtins.h"
+#include "interpreter/numconv.h"
 #include "error.h"
+#include "interpreter/vm.h"
+
+static inline void write_output(const char* text, const size_t len) {
+        current_vm->io.write(current_vm->io.userdata, text, len);
+}
 
 Object print_value(const uintptr_t argc, const Object* obj) {
+        // straight to the output of the instance; only functions and bigints go through tostring
         for (uintptr_t iarg=0; iarg<argc; iarg++) {
-                if (obj[iarg].type == TYPE_STRING) {
-                        printf("\"%s\"\n", obj[iarg].strval->value);
-                }
-                else {
-                        Object o = tostring(1, &obj[iarg]);
-                        if (o.type == TYPE_ERROR) {
-                                return o;
-                        } else {
-                                puts(o.strval->value);
-                                free_string(o.strval);
+                switch (OBJ_TYPE(obj[iarg])) {
+                        case TYPE_INT: {
+                                char buffer[INT_CHARS+1];
+                                buffer[INT_CHARS] = '\n';
+                                const char *const start = format_int(AS_INT(obj[iarg]), buffer+INT_CHARS);
+                                write_output(start, buffer+INT_CHARS+1-start);
+                                break;
+                        }
+                        case TYPE_BOOL:
+                                if (AS_INT(obj[iarg])) write_output("true\n", 5);
+                                else write_output("false\n", 6);
+                                break;
+                        case TYPE_NONE:
+                                write_output("none\n", 5);
+                                break;
+                        case TYPE_FLOAT: {
+                                char buffer[FLOAT_CHARS+1];
+                                const size_t len = format_float(AS_FLOAT(obj[iarg]), buffer);
+                                buffer[len] = '\n';
+                                write_output(buffer, len+1);
+                                break;
+                        }
+                        case TYPE_STRING: {
+                                ObjString *const string = AS_STRING(obj[iarg]);
+                                write_output("\"", 1);
+                                write_output(stringValue(string), string->len);
+                                write_output("\"\n", 2);
+                                break;
+                        }
+                        default: {
+                                Object o = tostring(1, &obj[iarg]);
+                                if (OBJ_TYPE(o) == TYPE_ERROR) return o;
+                                write_output(stringValue(AS_STRING(o)), AS_STRING(o)->len);
+                                write_output("\n", 1);
+                                break;
                         }
                 }
         }
@@ -25,7 +57,7 @@ Object print_value(const uintptr_t argc, const Object* obj) {
 
 Object native_clock(const uintptr_t argc, const Object* obj) {
         if (argc) return ERROR;
-        return (Object) {.type=TYPE_FLOAT, .floatval=((double)clock())/(CLOCKS_PER_SEC)};
+        return OBJ_FLOAT(((double)clock())/(CLOCKS_PER_SEC));
 }
 
 Object input(const uintptr_t argc, const Object* obj) {
@@ -37,10 +69,10 @@ Object input(const uintptr_t argc, const Object* obj) {
                 case 1:
                         print_value(argc, obj);
                 case 0:
-                        length = getline(&string, &bufsize, stdin);
+                        length = current_vm->io.read_line(current_vm->io.userdata, &string, &bufsize);
                         if (length == -1) length = 0;
                         else if (length > 0) length--; // remove final CRLF
-                        result = (Object) {.type=TYPE_STRING, .strval=makeString(string, length)};
+                        result = OBJ_STRING(makeString(string, length));
                         free(string);
                         break;
                 default:
@@ -55,15 +87,16 @@ Object tostring(const uintptr_t argc, const Object* obj) {
         static const size_t buflen = 256;
         char result[buflen];
         int len;
-        switch (obj->type) {
-                case TYPE_INT:
-                        len = snprintf(result, buflen, "%ld", obj->intval);
-                        break;
+        switch (OBJ_TYPE(*obj)) {
+                case TYPE_INT: {
+                        const char *const start = format_int(AS_INT(*obj), result+buflen);
+                        return OBJ_STRING(makeString(start, result+buflen-start));
+                }
                 case TYPE_BOOL:
-                        len = snprintf(result, buflen, obj->intval?"true":"false");
+                        len = snprintf(result, buflen, AS_INT(*obj)?"true":"false");
                         break;
                 case TYPE_FLOAT:
-                        len = snprintf(result, buflen, "%f", obj->floatval);
+                        len = format_float(AS_FLOAT(*obj), result);
                         break;
                 case TYPE_NONE:
                         len = snprintf(result, buflen, "none");
@@ -76,16 +109,25 @@ Object tostring(const uintptr_t argc, const Object* obj) {
                 case TYPE_USERF:
                         len = snprintf(result, buflen, "<user-defined function>");
                         break;
+                case TYPE_BIGINT:
+                        return OBJ_STRING(bigint_to_string(AS_BIGINT(*obj)));
                 default:
                         return ERROR;
         }
-        return (Object){.type=TYPE_STRING, .strval=makeString(result, len)};
+        return OBJ_STRING(makeString(result, len));
+}
+static size_t skip_spaces(const char** text, const size_t len) {
+        // int() and float() ignore leading whitespace, like strtod does; returns how much
+        size_t i = 0;
+        while (i < len && ((*text)[i] == ' ' || ((*text)[i] >= '\t' && (*text)[i] <= '\r'))) i++;
+        *text += i;
+        return i;
 }
 Object tobool(const uintptr_t argc, const Object* obj) {
         if (argc != 1) return ERROR;
-        switch (obj->type) {
+        switch (OBJ_TYPE(*obj)) {
                 case TYPE_INT:
-                        return obj->intval ? OBJ_TRUE : OBJ_FALSE;
+                        return AS_INT(*obj) ? OBJ_TRUE : OBJ_FALSE;
                 case TYPE_BOOL:
                         return *obj;
                 case TYPE_FLOAT:
@@ -93,33 +135,41 @@ Object tobool(const uintptr_t argc, const Object* obj) {
                 case TYPE_NONE:
                         return OBJ_FALSE;
                 case TYPE_STRING:
-                        return obj->strval->len ? OBJ_TRUE : OBJ_FALSE;
+                        return AS_STRING(*obj)->len ? OBJ_TRUE : OBJ_FALSE;
                 case TYPE_NATIVEF:
                         return OBJ_TRUE;
+                case TYPE_BIGINT:
+                        return OBJ_TRUE;
                 default:
                         return ERROR;
         }
 }
 Object toint(const uintptr_t argc, const Object* obj) {
         if (argc != 1) return ERROR;
-        switch (obj->type) {
+        switch (OBJ_TYPE(*obj)) {
                 case TYPE_INT:
+                case TYPE_BIGINT:
                         return *obj;
                 case TYPE_BOOL:
-                        return (Object) {.type=TYPE_INT, .intval=obj->intval};
+                        return OBJ_INT(AS_INT(*obj));
                 case TYPE_FLOAT:
-                        return (Object) {.type=TYPE_INT, .intval=obj->floatval};
+                        return OBJ_INT(AS_FLOAT(*obj));
                 case TYPE_NONE:
                         return ERROR;
                 case TYPE_STRING:
-                        if (obj->strval->len) {
-                                char* end;
-                                intmax_t result = strtoll(obj->strval->value, &end, 10);
-                                if (end - obj->strval->value == obj->strval->len) {
-                                        return (Object) {.type=TYPE_INT, .intval=result};
+                        {
+                                const char* value = stringValue(AS_STRING(*obj));
+                                const size_t len = AS_STRING(*obj)->len - skip_spaces(&value, AS_STRING(*obj)->len);
+                                intmax_t result;
+                                switch (parse_int(value, len, &result)) {
+                                        case PARSE_OK:
+                                                return OBJ_INT(result);
+                                        case PARSE_OVERFLOW:
+                                                return bigint_parse(value, len);
+                                        default:
+                                                return ERROR;
                                 }
                         }
-                        return ERROR;
                 case TYPE_NATIVEF:
                         return ERROR;
                 default:
@@ -128,24 +178,27 @@ Object toint(const uintptr_t argc, const Object* obj) {
 }
 Object tofloat(const uintptr_t argc, const Object* obj) {
         if (argc != 1) return ERROR;
-        switch (obj->type) {
+        switch (OBJ_TYPE(*obj)) {
                 case TYPE_INT:
-                        return (Object) {.type=TYPE_FLOAT, .floatval=obj->intval};
+                        return OBJ_FLOAT(AS_INT(*obj));
                 case TYPE_BOOL:
-                        return (Object) {.type=TYPE_FLOAT, .floatval=obj->intval};
+                        return OBJ_FLOAT(AS_INT(*obj));
+                case TYPE_BIGINT:
+                        return OBJ_FLOAT(bigint_to_double(*obj));
                 case TYPE_FLOAT:
                         return *obj;
                 case TYPE_NONE:
                         return ERROR;
                 case TYPE_STRING:
-                        if (obj->strval->len) {
-                                char* end;
-                                double result = strtod(obj->strval->value, &end);
-                                if (end - obj->strval->value == obj->strval->len) {
-                                        return (Object) {.type=TYPE_FLOAT, .floatval=result};
+                        {
+                                const char* value = stringValue(AS_STRING(*obj));
+                                const size_t len = AS_STRING(*obj)->len - skip_spaces(&value, AS_STRING(*obj)->len);
+                                double result;
+                                if (parse_float(value, len, &result) == PARSE_OK) {
+                                        return OBJ_FLOAT(result);
                                 }
+                                return ERROR;
                         }
-                        return ERROR;
                 case TYPE_NATIVEF:
                         return ERROR;
                 default:
@@ -0,0 +1,382 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+
+#include "interpreter/cache.h"
+#include "interpreter/node.h"
+#include "interpreter/function.h"
+#include "interpreter/string.h"
+#include "interpreter/jit.h"
+#include "identifiers_record.h"
+#include "hash.h"
+
+#define CACHE_VERSION 4 // bump whenever the serialized form of a node changes
+#define NULL_NODE UINT16_MAX
+#define NULL_STRING UINT32_MAX
+#define MAX_STRING (UINT32_C(1) << 30) // anything longer is a corrupted file
+#define MAX_FRAME_SIZE (UINT32_C(1) << 20) // anything larger is a corrupted file
+#define END_MARK UINT32_C(0x444E45) // "END"
+
+typedef struct CacheHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t nb_operators; // changes to the Operator enum invalidate the cache
+        CacheKey key;
+} CacheHeader;
+
+static CacheHeader mk_header(const CacheKey key) {
+        CacheHeader header;
+        memset(&header, 0, sizeof(header)); // no uninitialized padding in the file
+        memcpy(header.magic, "mylangc", 8);
+        header.version = CACHE_VERSION;
+        header.nb_operators = LEN_OPERATORS;
+        header.key = key;
+        return header;
+}
+
+CacheKey cache_key(FILE* source) {
+        char buffer[4096];
+        HashState state;
+        uint64_t len = 0;
+        size_t got;
+        hash_start(&state);
+        while ((got = fread(buffer, 1, sizeof(buffer), source)) > 0) {
+                hash_update(&state, buffer, got);
+                len += got;
+        }
+        const CacheKey key = {.length=len, .hash=hash_finish(&state)};
+        rewind(source);
+        return key;
+}
+
+// ------------------------------ store ----------------------------------------
+
+static void put(FILE* file, const void* data, const size_t size) {
+        fwrite(data, size, 1, file);
+}
+static void put_u32(FILE* file, const uint32_t value) {
+        put(file, &value, sizeof(value));
+}
+static void put_string(FILE* file, const char* string, const uint32_t length) {
+        if (string == NULL) {
+                put_u32(file, NULL_STRING);
+                return;
+        }
+        put_u32(file, length);
+        put(file, string, length);
+}
+static void put_token(FILE* file, const Token* token) {
+        put_u32(file, token->offset);
+        put_u32(file, token->type);
+        put_string(file, token->length ? token->source : NULL, token->length);
+}
+static void put_node(FILE* file, const Node* node) {
+        if (node == NULL) {
+                const uint16_t op = NULL_NODE;
+                put(file, &op, sizeof(op));
+                return;
+        }
+        const uint16_t op = node->operator;
+        put(file, &op, sizeof(op));
+        put_token(file, &(node->token));
+
+        switch (node->operator) {
+                case OP_LITERAL_TRUE:
+                case OP_LITERAL_FALSE:
+                case OP_LITERAL_NONE:
+                        return;
+                case OP_LITERAL_INT:
+                case OP_LITERAL_FLOAT:
+                        put(file, &(node->operands[0].obj), sizeof(node->operands[0].obj));
+                        return;
+                case OP_LITERAL_STR: {
+                        ObjString *const str = node->operands[0].obj.strval;
+                        put_string(file, stringValue(str), str->len);
+                        return;
+                }
+                case OP_LITERAL_FUNCTION: {
+                        const ObjFunction *const fun = node->operands[0].obj.funval;
+                        put_u32(file, fun->arity);
+                        put_u32(file, fun->level);
+                        put_u32(file, fun->frame_size);
+                        for (size_t i=0; i<fun->arity; i++) put_string(file, fun->arguments[i], strlen(fun->arguments[i]));
+                        put_node(file, fun->body);
+                        return;
+                }
+                case OP_VARIABLE:
+                case OP_FORGET:
+                        put_u32(file, node->operands[0].len);
+                        for (uintptr_t i=1; i<=node->operands[0].len; i++) {
+                                put_u32(file, node->operands[i].addr.depth);
+                                put_u32(file, node->operands[i].addr.slot);
+                        }
+                        return;
+                case OP_INVARIANT:
+                        put_u32(file, node->operands[1].addr.depth);
+                        put_u32(file, node->operands[1].addr.slot);
+                        put_node(file, node->operands[0].nd);
+                        return;
+                default:
+                        break;
+        }
+
+        const ChildRange children = childRange(node);
+        put_u32(file, children.end);
+        for (uintptr_t i=children.first; i<children.end; i++) put_node(file, node->operands[i].nd);
+}
+
+void store_cached_program(const parser_info* prsinfo, const char* cache_path, const CacheKey key, const Node* program) {
+        // written aside then renamed, so that concurrent runs never see a partial file
+        const size_t pathlen = strlen(cache_path) + 32;
+        char *const tmp_path = malloc(pathlen);
+        snprintf(tmp_path, pathlen, "%s.%ld.tmp", cache_path, (long) getpid());
+
+        FILE *const file = fopen(tmp_path, "wb");
+        if (file == NULL) {
+                LOG("Can't write the cache file %s", tmp_path);
+                free(tmp_path);
+                return;
+        }
+
+        const CacheHeader header = mk_header(key);
+        put(file, &header, sizeof(header));
+
+        const uint32_t globals = nb_globals(prsinfo);
+        put_u32(file, globals);
+        for (uint32_t i=0; i<globals; i++) put_string(file, global_name(prsinfo, i), strlen(global_name(prsinfo, i)));
+
+        put_node(file, program);
+        put_u32(file, END_MARK);
+
+        const int failed = ferror(file);
+        if (fclose(file) || failed || rename(tmp_path, cache_path)) {
+                LOG("Failed to write the cache file %s", cache_path);
+                remove(tmp_path);
+        }
+        free(tmp_path);
+}
+
+// ------------------------------ load -----------------------------------------
+
+typedef struct ReaderScope {
+        // the function being read, so that addresses can be checked against its frame and the enclosing ones
+        const struct ReaderScope* enclosing; // NULL for top-level functions
+        uint32_t frame_size;
+        unsigned int level;
+} ReaderScope;
+
+typedef struct CacheReader {
+        FILE* file;
+        parser_info* prsinfo;
+        const ReaderScope* scope; // NULL at top level
+        int ok;
+} CacheReader;
+
+static void get(CacheReader *const reader, void* data, const size_t size) {
+        if (reader->ok && size && fread(data, size, 1, reader->file) != 1) reader->ok = 0;
+}
+static uint32_t get_u32(CacheReader *const reader) {
+        uint32_t value = 0;
+        get(reader, &value, sizeof(value));
+        return value;
+}
+static char* get_string(CacheReader *const reader, uint32_t *const length) {
+        // returns a null-terminated string
+        *length = get_u32(reader);
+        if (!reader->ok || *length == NULL_STRING || *length > MAX_STRING) {
+                if (*length != NULL_STRING) reader->ok = 0;
+                *length = 0;
+                return NULL;
+        }
+        char *const string = malloc(*length+1);
+        get(reader, string, *length);
+        string[*length] = '\0';
+        return string;
+}
+static char* get_identifier(CacheReader *const reader, uint32_t *const length) {
+        // internalized, so that it outlives the reader
+        char *const string = get_string(reader, length);
+        if (string == NULL) return NULL;
+        char *const interned = internalize(&(reader->prsinfo->lxinfo.record), string, *length);
+        free(string);
+        return interned;
+}
+static Address get_address(CacheReader *const reader) {
+        // a global known to the file, or a slot of a frame in lexical reach
+        Address addr;
+        addr.depth = get_u32(reader);
+        addr.slot = get_u32(reader);
+        if (addr.depth == ADDR_GLOBAL) {
+                if (addr.slot >= nb_globals(reader->prsinfo)) reader->ok = 0;
+                return addr;
+        }
+        const ReaderScope* scope = reader->scope;
+        for (uint32_t i=0; i<addr.depth && scope != NULL; i++) scope = scope->enclosing;
+        if (scope == NULL || addr.slot >= scope->frame_size) reader->ok = 0;
+        return addr;
+}
+static void get_token(CacheReader *const reader, Token *const token) {
+        token->offset = get_u32(reader);
+        token->type = get_u32(reader);
+        uint32_t length;
+        token->source = get_identifier(reader, &length);
+        if (token->source != NULL && length > MAX_TOKEN_LENGTH) reader->ok = 0;
+        token->length = length;
+}
+static Node* get_node(CacheReader *const reader) {
+        // returns NULL for a null node, or on error (then reader->ok is cleared)
+        uint16_t op = NULL_NODE;
+        get(reader, &op, sizeof(op));
+        if (!reader->ok || op == NULL_NODE) return NULL;
+        if (op >= LEN_OPERATORS) {
+                reader->ok = 0;
+                return NULL;
+        }
+
+        Token token;
+        get_token(reader, &token);
+        Node* node;
+
+        switch (op) {
+                case OP_LITERAL_INT:
+                case OP_LITERAL_FLOAT:
+                        node = allocateNode(reader->prsinfo, 1);
+                        get(reader, &(node->operands[0].obj), sizeof(node->operands[0].obj));
+                        break;
+                case OP_LITERAL_TRUE:
+                case OP_LITERAL_FALSE:
+                case OP_LITERAL_NONE:
+                        node = allocateNode(reader->prsinfo, 0);
+                        break;
+                case OP_LITERAL_STR: {
+                        uint32_t length;
+                        char *const value = get_string(reader, &length);
+                        node = allocateNode(reader->prsinfo, 1);
+                        node->operands[0].obj.strval = makeString(value ? value : "", length);
+                        free(value);
+                        break;
+                }
+                case OP_LITERAL_FUNCTION: {
+                        const uint32_t arity = get_u32(reader);
+                        if (!reader->ok || arity > UINT16_MAX) {
+                                reader->ok = 0;
+                                return NULL;
+                        }
+                        ObjFunction *const fun = createFunction(arity);
+                        fun->arity = arity;
+                        fun->level = get_u32(reader);
+                        fun->frame_size = get_u32(reader);
+                        const ReaderScope scope = {
+                                .enclosing=reader->scope,
+                                .frame_size=fun->frame_size,
+                                .level=(reader->scope == NULL) ? 1 : reader->scope->level+1,
+                        };
+                        if (fun->level != scope.level || fun->frame_size < arity || fun->frame_size > MAX_FRAME_SIZE) reader->ok = 0;
+                        for (size_t i=0; i<arity; i++) {
+                                uint32_t length;
+                                fun->arguments[i] = get_identifier(reader, &length);
+                        }
+                        reader->scope = &scope;
+                        fun->body = get_node(reader);
+                        reader->scope = scope.enclosing;
+                        if (!reader->ok) {
+                                free_function(fun);
+                                return NULL;
+                        }
+                        registerFunction(fun);
+                        node = allocateNode(reader->prsinfo, 1);
+                        node->operands[0].obj.funval = fun;
+                        break;
+                }
+                case OP_VARIABLE:
+                case OP_FORGET: {
+                        const uint32_t len = get_u32(reader);
+                        if (!reader->ok || len > UINT16_MAX) {
+                                reader->ok = 0;
+                                return NULL;
+                        }
+                        node = allocateNode(reader->prsinfo, len+1);
+                        node->operands[0].len = len;
+                        for (uintptr_t i=1; i<=len; i++) node->operands[i].addr = get_address(reader);
+                        break;
+                }
+                case OP_INVARIANT:
+                        node = allocateNode(reader->prsinfo, 2);
+                        node->operands[1].addr = get_address(reader);
+                        node->operands[0].nd = get_node(reader);
+                        break;
+                default: {
+                        const uint32_t end = get_u32(reader);
+                        if (!reader->ok || end > UINT16_MAX) {
+                                reader->ok = 0;
+                                return NULL;
+                        }
+                        node = allocateNode(reader->prsinfo, (op == OP_WHILE) ? JIT_LOOP+1 : (end ? end : 1));
+                        node->operator = op;
+                        if (op == OP_WHILE) {
+                                node->operands[JIT_HOTNESS].len = 0;
+                                node->operands[JIT_LOOP].jit = NULL;
+                        }
+                        node->operands[0].len = end-1; // only meaningful for nodes of variable arity
+                        const ChildRange children = childRange(node);
+                        if (children.end != end) {
+                                reader->ok = 0;
+                                return NULL;
+                        }
+                        for (uintptr_t i=children.first; i<children.end; i++) node->operands[i].nd = NULL;
+                        for (uintptr_t i=children.first; i<children.end && reader->ok; i++) node->operands[i].nd = get_node(reader);
+                        break;
+                }
+        }
+
+        node->token = token;
+        node->operator = op;
+        if (!reader->ok) return NULL;
+        return node;
+}
+
+Node* load_cached_program(parser_info *const prsinfo, const char* cache_path, const CacheKey key) {
+        FILE *const file = fopen(cache_path, "rb");
+        if (file == NULL) return NULL;
+
+        CacheReader reader = {.file=file, .prsinfo=prsinfo, .scope=NULL, .ok=1};
+        Node* program = NULL;
+
+        const CacheHeader expected = mk_header(key);
+        CacheHeader header;
+        get(&reader, &header, sizeof(header));
+        if (!reader.ok || memcmp(&header, &expected, sizeof(header))) {
+                LOG("Stale cache file %s", cache_path);
+                goto end;
+        }
+
+        // global slots were assigned at parse time, they must be assigned the same way now
+        const uint32_t globals = get_u32(&reader);
+        for (uint32_t i=0; i<globals && reader.ok; i++) {
+                uint32_t length;
+                char const* name = get_identifier(&reader, &length);
+                if (name == NULL || record_global(prsinfo, name) != i) reader.ok = 0;
+        }
+        if (!reader.ok) goto end;
+
+        program = get_node(&reader);
+        if (reader.ok && get_u32(&reader) == END_MARK && reader.ok) {
+                LOG("Loaded the program from %s", cache_path);
+        } else {
+                LOG("Corrupted cache file %s", cache_path);
+                program = NULL;
+        }
+
+        end:
+        fclose(file);
+        return program;
+}
+
+#undef CACHE_VERSION
+#undef NULL_NODE
+#undef NULL_STRING
+#undef MAX_STRING
+#undef MAX_FRAME_SIZE
+#undef END_MARK
@@ -1,14 +1,35 @@
 #include <stdlib.h>
+#include <string.h>
 
 #include "interpreter/node.h"
 #include "interpreter/function.h"
+#include "interpreter/gc.h"
+
+static inline size_t function_size(const size_t arity) {
+        return offsetof(ObjFunction, arguments) + sizeof(char*)*arity;
+}
 
 ObjFunction* createFunction(const size_t arity) {
-        return malloc(offsetof(ObjFunction, arguments) + sizeof(char*)*arity);
+        ObjFunction *const fun = malloc(function_size(arity));
+        fun->body = NULL;
+        fun->frame_size = 0;
+        fun->env = (Environment) {.frame=0, .serial=0};
+        return fun;
 }
 ObjFunction* reallocFunction(ObjFunction* fun, const size_t arity) {
-        return realloc(fun, offsetof(ObjFunction, arguments) + sizeof(char*)*arity);
+        return realloc(fun, function_size(arity));
+}
+ObjFunction* bindFunction(const ObjFunction* fun, const Environment env) {
+        ObjFunction *const bound = malloc(function_size(fun->arity));
+        memcpy(bound, fun, function_size(fun->arity));
+        bound->env = env;
+        registerFunction(bound);
+        return bound;
+}
+void registerFunction(ObjFunction* fun) {
+        gc_track(&(fun->gc), GC_FUNCTION, function_size(fun->arity));
 }
 void free_function(ObjFunction* function) {
+        // the body belongs to the parser's arena
         free(function);
 }
@@ -0,0 +1,160 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "interpreter/gc.h"
+#include "interpreter/namespace.h"
+#include "interpreter/node.h"
+#include "interpreter/string.h"
+#include "interpreter/function.h"
+#include "interpreter/object.h"
+#include "interpreter/vm.h"
+
+#define GC_INITIAL_THRESHOLD (1<<18) // bytes; as fast as bigger ones on benchmarks/interpreter, in a fraction of the memory
+#define GC_GROW_FACTOR 2
+
+void mk_heap(GCHeap *const heap) {
+        *heap = (GCHeap) {.objects=NULL, .stats={.threshold=GC_INITIAL_THRESHOLD}};
+}
+
+void gc_track(GCObject *const object, const GCKind kind, const size_t size) {
+        GCHeap *const heap = &(current_vm->heap);
+        *object = (GCObject) {.next=heap->objects, .size=size, .kind=kind, .marked=0};
+        heap->objects = object;
+
+        heap->stats.objects_allocated++;
+        heap->stats.bytes_allocated += size;
+        if (heap->stats.bytes_allocated > heap->stats.peak_bytes) heap->stats.peak_bytes = heap->stats.bytes_allocated;
+}
+void gc_grow(GCObject *const object, const size_t extra) {
+        GCStats *const stats = &(current_vm->heap.stats);
+        object->size += extra;
+        stats->bytes_allocated += extra;
+        if (stats->bytes_allocated > stats->peak_bytes) stats->peak_bytes = stats->bytes_allocated;
+}
+int gc_pending(void) {
+        const GCStats *const stats = &(current_vm->heap.stats);
+        return stats->bytes_allocated > stats->threshold;
+}
+
+// ------------------------------ mark -----------------------------------------
+
+static void mark_object(GCObject *const object);
+
+static void mark_tree(const Node* node) {
+        // literals are the only way for the AST to reference heap objects
+        if (node == NULL) return;
+        switch (node->operator) {
+                case OP_LITERAL_STR:
+                        mark_object(&(node->operands[0].obj.strval->gc));
+                        return;
+                case OP_LITERAL_FUNCTION:
+                        mark_object(&(node->operands[0].obj.funval->gc));
+                        return;
+                default:
+                        break;
+        }
+        const ChildRange children = childRange(node);
+        for (uintptr_t i=children.first; i<children.end; i++) mark_tree(node->operands[i].nd);
+}
+static void mark_string(ObjString* str) {
+        // same walk as the rope flattening: loop into the longer operand, recurse into the shorter one
+        while (!str->gc.marked) {
+                str->gc.marked = 1;
+                if (str->left == NULL) return;
+                if (str->left->len >= str->right->len) {
+                        mark_string(str->right);
+                        str = str->left;
+                } else {
+                        mark_string(str->left);
+                        str = str->right;
+                }
+        }
+}
+static void mark_object(GCObject *const object) {
+        if (object->kind == GC_STRING) {
+                mark_string((ObjString*) object);
+                return;
+        }
+        if (object->marked) return;
+        object->marked = 1;
+        if (object->kind == GC_FUNCTION) mark_tree(((ObjFunction*) object)->body);
+}
+static void mark_value(const Object value) {
+        GCObject *const object = heap_object(value);
+        if (object != NULL) mark_object(object);
+}
+
+// ------------------------------ sweep ----------------------------------------
+
+static void release(GCStats *const stats, GCObject *const object) {
+        stats->objects_freed++;
+        stats->bytes_freed += object->size;
+        stats->bytes_allocated -= object->size;
+        switch (object->kind) {
+                case GC_STRING:
+                        free_string((ObjString*) object);
+                        break;
+                case GC_FUNCTION:
+                        free_function((ObjFunction*) object);
+                        break;
+                case GC_INT:
+#ifdef NAN_BOXING
+                        free_boxed_int((ObjInt*) object);
+#endif
+                        break;
+                case GC_BIGINT:
+                        free_bigint((ObjBigInt*) object);
+                        break;
+        }
+}
+static void sweep(GCHeap *const heap) {
+        GCObject** link = &(heap->objects);
+        while (*link != NULL) {
+                GCObject *const object = *link;
+                if (object->marked) {
+                        object->marked = 0;
+                        link = &(object->next);
+                } else {
+                        *link = object->next;
+                        release(&(heap->stats), object);
+                }
+        }
+}
+
+void collect_garbage(Namespace *const ns) {
+        const Frame top = ns->frames[ns->nb_frames-1];
+        for (size_t i=0; i<top.base+top.len; i++) mark_value(ns->values[i]);
+        for (size_t i=0; i<ns->stack_top; i++) mark_value(ns->stack[i]);
+        mark_value(ns->staging);
+        mark_tree(ns->statement);
+
+        GCHeap *const heap = &(current_vm->heap);
+        sweep(heap);
+
+        heap->stats.collections++;
+        heap->stats.threshold = heap->stats.bytes_allocated * GC_GROW_FACTOR;
+        if (heap->stats.threshold < GC_INITIAL_THRESHOLD) heap->stats.threshold = GC_INITIAL_THRESHOLD;
+
+        LOG("Collection done, %lu bytes alive, next collection at %lu", heap->stats.bytes_allocated, heap->stats.threshold);
+}
+void free_heap(void) {
+        GCHeap *const heap = &(current_vm->heap);
+        while (heap->objects != NULL) {
+                GCObject *const next = heap->objects->next;
+                release(&(heap->stats), heap->objects);
+                heap->objects = next;
+        }
+}
+
+GCStats gc_stats(void) {
+        return current_vm->heap.stats;
+}
+void print_gc_stats(FILE* file) {
+        const GCStats stats = current_vm->heap.stats;
+        fprintf(file, "GC: %lu collections, %lu of %lu objects freed (%lu bytes), %lu bytes alive, peak %lu bytes.\n",
+                stats.collections, stats.objects_freed, stats.objects_allocated, stats.bytes_freed,
+                stats.bytes_allocated, stats.peak_bytes);
+}
+
+#undef GC_INITIAL_THRESHOLD
+#undef GC_GROW_FACTOR
@@ -7,6 +7,12 @@
 #include "interpreter/node.h"
 #include "error.h"
 #include "interpreter/builtins.h"
+#include "interpreter/gc.h"
+#include "interpreter/cache.h"
+#include "interpreter/optimizer.h"
+#include "interpreter/profiler.h"
+#include "interpreter/jit.h"
+#include "interpreter/vm.h"
 
 
 static Object interpretExpression(const Node* root, Namespace *const ns);
@@ -20,18 +26,69 @@ void mk_interpreter_info(interpreter_info *const interp) {
 }
 void del_interpreter_info(interpreter_info *const interp) {
         freeNamespace(&(interp->ns));
+        free_heap();
+        jit_release();
 }
 
-static Object interpretVariable(const Node* root, Namespace *const ns) {
-        Object* obj = ns_get_value(ns, root->token.tok.source);
-        if (obj == NULL) {
-                Error(&(root->token), "Undefined variable.\n");
-                return ERROR;
+static Object* getVariable(const Node* variable, Namespace *const ns) {
+        // addresses are sorted innermost first by the resolver
+        const uintptr_t nb_addresses = variable->operands[0].len;
+        for (uintptr_t i=1; i<=nb_addresses; i++) {
+                Object *const obj = ns_get_value(ns, variable->operands[i].addr);
+                if (obj != NULL) return obj;
         }
+        Error(&(variable->token), "Undefined variable.\n");
+        return NULL;
+}
+
+static Object interpretVariable(const Node* root, Namespace *const ns) {
+        Object* obj = getVariable(root, ns);
+        if (obj == NULL) return ERROR;
         else return *obj;
 }
+static Object interpretRooted(const Node* root, Namespace *const ns, const Object alive) {
+        // `alive` is only known to our caller's C frame; it must survive collections while `root` runs
+        if (heap_object(alive) == NULL) return interpretExpression(root, ns);
+        const size_t mark = ns_push(ns, alive);
+        const Object result = interpretExpression(root, ns);
+        ns->stack_top = mark;
+        return result;
+}
+static inline const Node* quicken(const Node* root, const Operator operator) {
+        // rewrites a node in place, between a generic operator and its quickened variants
+        ((Node*) root)->operator = operator;
+        return root;
+}
+/*
+Integer arithmetic checks for overflow, and goes on with bigints when the
+result doesn't fit in an int. The operands are ints or bools.
+*/
+static inline Object int_add(const Object opA, const Object opB) {
+        intmax_t result;
+        if (__builtin_add_overflow(AS_INT(opA), AS_INT(opB), &result)) return bigint_add(opA, opB);
+        return OBJ_INT(result);
+}
+static inline Object int_sub(const Object opA, const Object opB) {
+        intmax_t result;
+        if (__builtin_sub_overflow(AS_INT(opA), AS_INT(opB), &result)) return bigint_sub(opA, opB);
+        return OBJ_INT(result);
+}
+static inline Object int_mul(const Object opA, const Object opB) {
+        intmax_t result;
+        if (__builtin_mul_overflow(AS_INT(opA), AS_INT(opB), &result)) return bigint_mul(opA, opB);
+        return OBJ_INT(result);
+}
+static inline Object int_neg(const Object operand) {
+        if (AS_INT(operand) == INTMAX_MIN) return bigint_negate(operand);
+        return OBJ_INT(-AS_INT(operand));
+}
+static inline Object int_div(const Object opA, const Object opB) {
+        // truncated; opB must not be 0
+        if (AS_INT(opA) == INTMAX_MIN && AS_INT(opB) == -1) return bigint_negate(opA);
+        return OBJ_INT(AS_INT(opA) / AS_INT(opB));
+}
 static Object interpretInt(const Node* root, Namespace *const ns) {
-        return (Object) {.type=TYPE_INT, .intval=root->operands[0].obj.intval};
+        return OBJ_INT(root->operands[0].obj.intval);
 }
 static Object interpretTrue(const Node* root, Namespace *const ns) {
         return OBJ_TRUE;
@@ -43,22 +100,37 @@ static Object interpretNone(const Node* root, Namespace *const ns) {
         return OBJ_NONE;
 }
 static Object interpretFloat(const Node* root, Namespace *const ns) {
-        return (Object) {.type=TYPE_FLOAT, .floatval=root->operands[0].obj.floatval};
+        return OBJ_FLOAT(root->operands[0].obj.floatval);
 }
 static Object interpretStr(const Node* root, Namespace *const ns) {
-        return (Object) {.type=TYPE_STRING, .strval=root->operands[0].obj.strval};
+        return OBJ_STRING(root->operands[0].obj.strval);
 }
 static Object interpretFunction(const Node* root, Namespace *const ns) {
-        return (Object) {.type=TYPE_USERF, .funval=root->operands[0].obj.funval};
+        ObjFunction *const function = root->operands[0].obj.funval;
+        // top-level functions only ever see the globals, nested ones are bound to the frame they are created in
+        if (function->level <= 1) return OBJ_USERF(function);
+        return OBJ_USERF(bindFunction(function, ns_environment(ns)));
+}
+static Object interpretInvariant(const Node* root, Namespace *const ns) {
+        // the slot is unset on each entry in the loop the expression was hoisted from
+        const Address addr = root->operands[1].addr;
+        Object *const cached = ns_get_value(ns, addr);
+        if (cached != NULL) return *cached;
+
+        Object value = interpretExpression(root->operands[0].nd, ns);
+        ERROR_GUARD(value);
+        ns_set_value(ns, addr, value);
+        return value;
 }
 static Object interpretUnaryPlus(const Node* root, Namespace *const ns) {
         Object operand = interpretExpression(root->operands[0].nd, ns);
         ERROR_GUARD(operand);
 
-        switch (operand.type) {
+        switch (OBJ_TYPE(operand)) {
                 case TYPE_INT:
                 case TYPE_BOOL:
                 case TYPE_FLOAT:
+                case TYPE_BIGINT:
                         return operand;
                 case TYPE_STRING:
                         Error(&(root->token), "TypeError: +str is illegal.\n");
@@ -72,14 +144,14 @@ static Object interpretUnaryMinus(const Node* root, Namespace *const ns) {
         Object operand = interpretExpression(root->operands[0].nd, ns);
         ERROR_GUARD(operand);
 
-        switch (operand.type) {
+        switch (OBJ_TYPE(operand)) {
                 case TYPE_INT:
                 case TYPE_BOOL:
-                        operand.intval *= -1;
-                        return operand;
+                        return int_neg(operand);
+                case TYPE_BIGINT:
+                        return bigint_negate(operand);
                 case TYPE_FLOAT:
-                        operand.floatval *= -1;
-                        return operand;
+                        return OBJ_FLOAT(-AS_FLOAT(operand));
                 case TYPE_STRING:
                         Error(&(root->token), "TypeError: -str is illegal.\n");
                         return ERROR;
@@ -88,221 +160,315 @@ static Object interpretUnaryMinus(const Node* root, Namespace *const ns) {
                         return ERROR;
         }
 }
-static Object interpretSum(const Node* root, Namespace *const ns) {
+static Object applySum(const Node* root, const Object opA, const Object opB) {
         static const void* dispatcher[LEN_OBJTYPES][LEN_OBJTYPES] =  {
                 [TYPE_INT] = {
-                        [TYPE_INT] = &&add_int_int,
+                        [TYPE_INT] = &&quicken_int_int,
                         [TYPE_BOOL] = &&add_int_int,
                         [TYPE_FLOAT] = &&add_int_float,
+                        [TYPE_BIGINT] = &&add_big,
                 },
                 [TYPE_BOOL] = {
                         [TYPE_INT] = &&add_int_int,
                         [TYPE_BOOL] = &&add_int_int,
                         [TYPE_FLOAT] = &&add_int_float,
+                        [TYPE_BIGINT] = &&add_big,
                 },
                 [TYPE_FLOAT] = {
                         [TYPE_INT] = &&add_float_int,
                         [TYPE_BOOL] = &&add_float_int,
-                        [TYPE_FLOAT] = &&add_float_float,
+                        [TYPE_FLOAT] = &&quicken_float_float,
+                        [TYPE_BIGINT] = &&add_float_big,
                 },
                 [TYPE_STRING] = {
                         [TYPE_STRING] = &&add_string_string,
                 },
+                [TYPE_BIGINT] = {
+                        [TYPE_INT] = &&add_big,
+                        [TYPE_BOOL] = &&add_big,
+                        [TYPE_BIGINT] = &&add_big,
+                        [TYPE_FLOAT] = &&add_big_float,
+                },
         };
 
-        Object opA = interpretExpression(root->operands[0].nd, ns);
-        ERROR_GUARD(opA);
-        Object opB = interpretExpression(root->operands[1].nd, ns);
-        ERROR_GUARD(opB);
         {
-                const void* handler = dispatcher[opA.type][opB.type];
+                const void* handler = dispatcher[OBJ_TYPE(opA)][OBJ_TYPE(opB)];
                 if (handler == NULL) goto error; // undefined array members are initialized to NULL (C99)
                 else goto *handler;
         }
 
+        quicken_int_int:
+        quicken(root, OP_SUM_INT_INT);
         add_int_int:
-        return (Object) {.type=TYPE_INT, .intval=(opA.intval+opB.intval)};
+        return int_add(opA, opB);
+
+        add_big:
+        return bigint_add(opA, opB);
+
+        add_big_float:
+        return OBJ_FLOAT(bigint_to_double(opA)+AS_FLOAT(opB));
+
+        add_float_big:
+        return OBJ_FLOAT(AS_FLOAT(opA)+bigint_to_double(opB));
 
         add_int_float:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.intval+opB.floatval)};
+        return OBJ_FLOAT(AS_INT(opA)+AS_FLOAT(opB));
 
         add_string_string:
-        return (Object) {.type=TYPE_STRING, .strval=concatenateStrings(opA.strval, opB.strval)};
+        return OBJ_STRING(concatenateStrings(AS_STRING(opA), AS_STRING(opB)));
 
         add_float_int:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.floatval+opB.intval)};
+        return OBJ_FLOAT(AS_FLOAT(opA)+AS_INT(opB));
 
-        add_float_float:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.floatval+opB.floatval)};
+        quicken_float_float:
+        quicken(root, OP_SUM_FLOAT_FLOAT);
+        return OBJ_FLOAT(AS_FLOAT(opA)+AS_FLOAT(opB));
 
         error:
         Error(&(root->token), "TypeError: ___+___ is illegal.\n");
         return ERROR;
 }
-static Object interpretDifference(const Node* root, Namespace *const ns) {
+static Object interpretSum(const Node* root, Namespace *const ns) {
+        Object opA = interpretExpression(root->operands[0].nd, ns);
+        ERROR_GUARD(opA);
+        Object opB = interpretRooted(root->operands[1].nd, ns, opA);
+        ERROR_GUARD(opB);
+        return applySum(root, opA, opB);
+}
+static Object applyDifference(const Node* root, const Object opA, const Object opB) {
         static const void* dispatcher[LEN_OBJTYPES][LEN_OBJTYPES] =  {
                 [TYPE_INT] = {
-                        [TYPE_INT] = &&sub_int_int,
+                        [TYPE_INT] = &&quicken_int_int,
                         [TYPE_BOOL] = &&sub_int_int,
                         [TYPE_FLOAT] = &&sub_int_float,
+                        [TYPE_BIGINT] = &&sub_big,
                 },
                 [TYPE_BOOL] = {
                         [TYPE_INT] = &&sub_int_int,
                         [TYPE_BOOL] = &&sub_int_int,
                         [TYPE_FLOAT] = &&sub_int_float,
+                        [TYPE_BIGINT] = &&sub_big,
                 },
                 [TYPE_FLOAT] = {
                         [TYPE_INT] = &&sub_float_int,
                         [TYPE_BOOL] = &&sub_float_int,
-                        [TYPE_FLOAT] = &&sub_float_float,
+                        [TYPE_FLOAT] = &&quicken_float_float,
+                        [TYPE_BIGINT] = &&sub_float_big,
+                },
+                [TYPE_BIGINT] = {
+                        [TYPE_INT] = &&sub_big,
+                        [TYPE_BOOL] = &&sub_big,
+                        [TYPE_BIGINT] = &&sub_big,
+                        [TYPE_FLOAT] = &&sub_big_float,
                 },
         };
 
-        Object opA = interpretExpression(root->operands[0].nd, ns);
-        ERROR_GUARD(opA);
-        Object opB = interpretExpression(root->operands[1].nd, ns);
-        ERROR_GUARD(opB);
         {
-                const void* handler = dispatcher[opA.type][opB.type];
+                const void* handler = dispatcher[OBJ_TYPE(opA)][OBJ_TYPE(opB)];
                 if (handler == NULL) goto error; // undefined array members are initialized to NULL (C99)
                 else goto *handler;
         }
 
+        quicken_int_int:
+        quicken(root, OP_DIFFERENCE_INT_INT);
         sub_int_int:
-        return (Object) {.type=TYPE_INT, .intval=(opA.intval-opB.intval)};
+        return int_sub(opA, opB);
+
+        sub_big:
+        return bigint_sub(opA, opB);
+
+        sub_big_float:
+        return OBJ_FLOAT(bigint_to_double(opA)-AS_FLOAT(opB));
+
+        sub_float_big:
+        return OBJ_FLOAT(AS_FLOAT(opA)-bigint_to_double(opB));
 
         sub_int_float:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.intval-opB.floatval)};
+        return OBJ_FLOAT(AS_INT(opA)-AS_FLOAT(opB));
 
         sub_float_int:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.floatval-opB.intval)};
+        return OBJ_FLOAT(AS_FLOAT(opA)-AS_INT(opB));
 
-        sub_float_float:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.floatval-opB.floatval)};
+        quicken_float_float:
+        quicken(root, OP_DIFFERENCE_FLOAT_FLOAT);
+        return OBJ_FLOAT(AS_FLOAT(opA)-AS_FLOAT(opB));
 
         error:
         Error(&(root->token), "TypeError: ___-___ is illegal.\n");
         return ERROR;
 }
-static Object interpretProduct(const Node* root, Namespace *const ns) {
+static Object interpretDifference(const Node* root, Namespace *const ns) {
+        Object opA = interpretExpression(root->operands[0].nd, ns);
+        ERROR_GUARD(opA);
+        Object opB = interpretRooted(root->operands[1].nd, ns, opA);
+        ERROR_GUARD(opB);
+        return applyDifference(root, opA, opB);
+}
+static Object applyProduct(const Node* root, const Object opA, const Object opB) {
         static const void* dispatcher[LEN_OBJTYPES][LEN_OBJTYPES] =  {
                 [TYPE_INT] = {
-                        [TYPE_INT] = &&mul_int_int,
+                        [TYPE_INT] = &&quicken_int_int,
                         [TYPE_BOOL] = &&mul_int_int,
                         [TYPE_FLOAT] = &&mul_int_float,
                         [TYPE_STRING] = &&mul_int_string,
+                        [TYPE_BIGINT] = &&mul_big,
                 },
                 [TYPE_BOOL] = {
                         [TYPE_INT] = &&mul_int_int,
                         [TYPE_BOOL] = &&mul_int_int,
                         [TYPE_FLOAT] = &&mul_int_float,
                         [TYPE_STRING] = &&mul_int_string,
+                        [TYPE_BIGINT] = &&mul_big,
                 },
                 [TYPE_FLOAT] = {
                         [TYPE_INT] = &&mul_float_int,
                         [TYPE_BOOL] = &&mul_float_int,
-                        [TYPE_FLOAT] = &&mul_float_float,
+                        [TYPE_FLOAT] = &&quicken_float_float,
+                        [TYPE_BIGINT] = &&mul_float_big,
                 },
                 [TYPE_STRING] = {
                         [TYPE_INT] = &&mul_string_int,
                         [TYPE_BOOL] = &&mul_string_int,
                 },
+                [TYPE_BIGINT] = {
+                        [TYPE_INT] = &&mul_big,
+                        [TYPE_BOOL] = &&mul_big,
+                        [TYPE_BIGINT] = &&mul_big,
+                        [TYPE_FLOAT] = &&mul_big_float,
+                },
         };
 
-        Object opA = interpretExpression(root->operands[0].nd, ns);
-        ERROR_GUARD(opA);
-        Object opB = interpretExpression(root->operands[1].nd, ns);
-        ERROR_GUARD(opB);
         {
-                const void* handler = dispatcher[opA.type][opB.type];
+                const void* handler = dispatcher[OBJ_TYPE(opA)][OBJ_TYPE(opB)];
                 if (handler == NULL) goto error; // undefined array members are initialized to NULL (C99)
                 else goto *handler;
         }
 
+        quicken_int_int:
+        quicken(root, OP_PRODUCT_INT_INT);
         mul_int_int:
-        return (Object) {.type=TYPE_INT, .intval=(opA.intval*opB.intval)};
+        return int_mul(opA, opB);
+
+        mul_big:
+        return bigint_mul(opA, opB);
+
+        mul_big_float:
+        return OBJ_FLOAT(bigint_to_double(opA)*AS_FLOAT(opB));
+
+        mul_float_big:
+        return OBJ_FLOAT(AS_FLOAT(opA)*bigint_to_double(opB));
 
         mul_int_float:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.intval*opB.floatval)};
+        return OBJ_FLOAT(AS_INT(opA)*AS_FLOAT(opB));
 
         mul_int_string:
-        if (opA.intval >= 0) return (Object) {.type=TYPE_STRING, .strval=multiplyString(opB.strval, opA.intval)};
+        if (AS_INT(opA) >= 0) return OBJ_STRING(multiplyString(AS_STRING(opB), AS_INT(opA)));
         else goto error;
 
         mul_string_int:
-        if (opB.intval >= 0) return (Object) {.type=TYPE_STRING, .strval=multiplyString(opA.strval, opB.intval)};
+        if (AS_INT(opB) >= 0) return OBJ_STRING(multiplyString(AS_STRING(opA), AS_INT(opB)));
         else goto error;
 
         mul_float_int:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.floatval*opB.intval)};
+        return OBJ_FLOAT(AS_FLOAT(opA)*AS_INT(opB));
 
-        mul_float_float:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.floatval*opB.floatval)};
+        quicken_float_float:
+        quicken(root, OP_PRODUCT_FLOAT_FLOAT);
+        return OBJ_FLOAT(AS_FLOAT(opA)*AS_FLOAT(opB));
 
         error:
         Error(&(root->token), "TypeError: ___*___ is illegal.\n");
         return ERROR;
 }
-static Object interpretDivision(const Node* root, Namespace *const ns) {
+static Object interpretProduct(const Node* root, Namespace *const ns) {
+        Object opA = interpretExpression(root->operands[0].nd, ns);
+        ERROR_GUARD(opA);
+        Object opB = interpretRooted(root->operands[1].nd, ns, opA);
+        ERROR_GUARD(opB);
+        return applyProduct(root, opA, opB);
+}
+static Object applyDivision(const Node* root, const Object opA, const Object opB) {
         static const void* dispatcher[LEN_OBJTYPES][LEN_OBJTYPES] =  {
                 [TYPE_INT] = {
                         [TYPE_INT] = &&div_int_int,
                         [TYPE_BOOL] = &&div_int_int,
                         [TYPE_FLOAT] = &&div_int_float,
+                        [TYPE_BIGINT] = &&div_big,
                 },
                 [TYPE_BOOL] = {
                         [TYPE_INT] = &&div_int_int,
                         [TYPE_BOOL] = &&div_int_int,
                         [TYPE_FLOAT] = &&div_int_float,
+                        [TYPE_BIGINT] = &&div_big,
                 },
                 [TYPE_FLOAT] = {
                         [TYPE_INT] = &&div_float_int,
                         [TYPE_BOOL] = &&div_float_int,
-                        [TYPE_FLOAT] = &&div_float_float,
+                        [TYPE_FLOAT] = &&quicken_float_float,
+                        [TYPE_BIGINT] = &&div_float_big,
+                },
+                [TYPE_BIGINT] = {
+                        [TYPE_INT] = &&div_big,
+                        [TYPE_BOOL] = &&div_big,
+                        [TYPE_BIGINT] = &&div_big,
+                        [TYPE_FLOAT] = &&div_big_float,
                 },
         };
 
-        Object opA = interpretExpression(root->operands[0].nd, ns);
-        ERROR_GUARD(opA);
-        Object opB = interpretExpression(root->operands[1].nd, ns);
-        ERROR_GUARD(opB);
         {
-                const void* handler = dispatcher[opA.type][opB.type];
+                const void* handler = dispatcher[OBJ_TYPE(opA)][OBJ_TYPE(opB)];
                 if (handler == NULL) goto error; // undefined array members are initialized to NULL (C99)
                 else goto *handler;
         }
 
         div_int_int:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.intval/(double)opB.intval)};
+        return OBJ_FLOAT(AS_INT(opA)/(double)AS_INT(opB));
+
+        div_big:
+        return OBJ_FLOAT(bigint_div(opA, opB));
+
+        div_big_float:
+        return OBJ_FLOAT(bigint_to_double(opA)/AS_FLOAT(opB));
+
+        div_float_big:
+        return OBJ_FLOAT(AS_FLOAT(opA)/bigint_to_double(opB));
 
         div_int_float:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.intval/opB.floatval)};
+        return OBJ_FLOAT(AS_INT(opA)/AS_FLOAT(opB));
 
         div_float_int:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.floatval/opB.intval)};
+        return OBJ_FLOAT(AS_FLOAT(opA)/AS_INT(opB));
 
-        div_float_float:
-        return (Object) {.type=TYPE_FLOAT, .floatval=(opA.floatval/opB.floatval)};
+        quicken_float_float:
+        quicken(root, OP_DIVISION_FLOAT_FLOAT);
+        return OBJ_FLOAT(AS_FLOAT(opA)/AS_FLOAT(opB));
 
         error:
         Error(&(root->token), "TypeError: ___/___ is illegal.\n");
         return ERROR;
 }
+static Object interpretDivision(const Node* root, Namespace *const ns) {
+        Object opA = interpretExpression(root->operands[0].nd, ns);
+        ERROR_GUARD(opA);
+        Object opB = interpretRooted(root->operands[1].nd, ns, opA);
+        ERROR_GUARD(opB);
+        return applyDivision(root, opA, opB);
+}
 static Object interpretAffect(const Node* root, Namespace *const ns) {
         Object obj = interpretExpression(root->operands[1].nd, ns);
         ERROR_GUARD(obj);
-        ns_set_value(ns, root->operands[0].nd->token.tok.source, obj);
+        ns_set_value(ns, root->operands[0].nd->operands[1].addr, obj);
         return obj;
 }
 static Object interpretInvert(const Node* root, Namespace *const ns) {
         Object operand = interpretExpression(root->operands[0].nd, ns);
         ERROR_GUARD(operand);
-        switch (operand.type) {
+        switch (OBJ_TYPE(operand)) {
                 case TYPE_INT:
-                        operand.type = TYPE_BOOL;
                 case TYPE_BOOL:
-                        operand.intval = !operand.intval;
-                        return operand;
+                        return OBJ_BOOL(!AS_INT(operand));
+                case TYPE_BIGINT:
+                        return OBJ_FALSE; // never 0
                 case TYPE_FLOAT:
                         Error(&(root->token), "TypeError: !float is illegal.\n");
                         return ERROR;
@@ -318,15 +484,15 @@ static Object interpretAnd(const Node* root, Namespace *const ns) {
         Object operand = interpretExpression(root->operands[0].nd, ns);
         ERROR_GUARD(operand);
         Object op_is_true = tobool(1, &operand);
-        if (op_is_true.type == TYPE_ERROR) {
+        if (OBJ_TYPE(op_is_true) == TYPE_ERROR) {
                 Error(&(root->token), "TypeError: can't cast ___ to bool.\n");
                 return ERROR;
         }
-        else if (!op_is_true.intval) return operand;
+        else if (!AS_INT(op_is_true)) return operand;
         else {
                 operand = interpretExpression(root->operands[1].nd, ns);
                 ERROR_GUARD(operand);
-                if (tobool(1, &operand).type == TYPE_ERROR) {
+                if (OBJ_TYPE(tobool(1, &operand)) == TYPE_ERROR) {
                         Error(&(root->token), "TypeError: can't cast ___ to bool.\n");
                         return ERROR;
                 }
@@ -337,25 +503,25 @@ static Object interpretOr(const Node* root, Namespace *const ns) {
         Object operand = interpretExpression(root->operands[0].nd, ns);
         ERROR_GUARD(operand);
         Object op_is_true = tobool(1, &operand);
-        if (op_is_true.type == TYPE_ERROR) {
+        if (OBJ_TYPE(op_is_true) == TYPE_ERROR) {
                 Error(&(root->token), "TypeError: can't cast ___ to bool.\n");
                 return ERROR;
         }
-        else if (op_is_true.intval) return operand;
+        else if (AS_INT(op_is_true)) return operand;
         else {
                 operand = interpretExpression(root->operands[1].nd, ns);
                 ERROR_GUARD(operand);
-                if (tobool(1, &operand).type == TYPE_ERROR) {
+                if (OBJ_TYPE(tobool(1, &operand)) == TYPE_ERROR) {
                         Error(&(root->token), "TypeError: can't cast ___ to bool.\n");
                         return ERROR;
                 }
                 return operand;
         }
 }
-static Object interpretEq(const Node* root, Namespace *const ns) {
+static Object applyEq(const Node* root, const Object opA, const Object opB) {
         static const void* dispatcher[LEN_OBJTYPES][LEN_OBJTYPES] = {
                 [TYPE_INT] = {
-                        [TYPE_INT] = &&eq_int_int,
+                        [TYPE_INT] = &&quicken_int_int,
                         [TYPE_BOOL] = &&eq_int_int,
                 },
                 [TYPE_BOOL] = {
@@ -368,435 +534,669 @@ static Object interpretEq(const Node* root, Namespace *const ns) {
                 [TYPE_NONE] = {
                         [TYPE_NONE] = && eq_none_none,
                 },
+                [TYPE_BIGINT] = {
+                        // bigints are normalized: they are never equal to an int
+                        [TYPE_BIGINT] = &&eq_big_big,
+                },
         };
 
-        Object opA = interpretExpression(root->operands[0].nd, ns);
-        ERROR_GUARD(opA);
-        Object opB = interpretExpression(root->operands[1].nd, ns);
-        ERROR_GUARD(opB);
         {
-                const void* handler = dispatcher[opA.type][opB.type];
+                const void* handler = dispatcher[OBJ_TYPE(opA)][OBJ_TYPE(opB)];
                 if (handler == NULL) goto error; // undefined array members are initialized to NULL (C99)
                 else goto *handler;
         }
 
+        quicken_int_int:
+        quicken(root, OP_EQ_INT_INT);
         eq_int_int:
-        return (Object) {.type=TYPE_BOOL, .intval=(opA.intval==opB.intval)};
+        return OBJ_BOOL(AS_INT(opA)==AS_INT(opB));
 
         eq_string_string:
-        if (opA.strval->len != opB.strval->len) return OBJ_FALSE;
-        return (Object) {.type=TYPE_BOOL, .intval=!strcmp(opA.strval->value, opB.strval->value)};
+        if (AS_STRING(opA)->len != AS_STRING(opB)->len) return OBJ_FALSE;
+        return OBJ_BOOL(!memcmp(stringValue(AS_STRING(opA)), stringValue(AS_STRING(opB)), AS_STRING(opA)->len));
 
         eq_none_none:
         return OBJ_TRUE;
 
+        eq_big_big:
+        return OBJ_BOOL(bigint_compare(opA, opB) == 0);
+
         error:
         // two objects of incompatible types are different
         return OBJ_FALSE;
 }
-static Object interpretLt(const Node* root, Namespace *const ns) {
+static Object interpretEq(const Node* root, Namespace *const ns) {
+        Object opA = interpretExpression(root->operands[0].nd, ns);
+        ERROR_GUARD(opA);
+        Object opB = interpretRooted(root->operands[1].nd, ns, opA);
+        ERROR_GUARD(opB);
+        return applyEq(root, opA, opB);
+}
+static Object applyLt(const Node* root, const Object opA, const Object opB) {
         static const void* dispatcher[LEN_OBJTYPES][LEN_OBJTYPES] = {
                 [TYPE_INT] = {
-                        [TYPE_INT] = &&lt_int_int,
+                        [TYPE_INT] = &&quicken_int_int,
                         [TYPE_BOOL] = &&lt_int_int,
                         [TYPE_FLOAT] = &&lt_int_float,
+                        [TYPE_BIGINT] = &&lt_big,
                 },
                 [TYPE_BOOL] = {
                         [TYPE_INT] = &&lt_int_int,
                         [TYPE_BOOL] = &&lt_int_int,
                         [TYPE_FLOAT] = &&lt_int_float,
+                        [TYPE_BIGINT] = &&lt_big,
                 },
                 [TYPE_FLOAT] = {
                         [TYPE_INT] = &&lt_float_int,
                         [TYPE_BOOL] = &&lt_float_int,
-                        [TYPE_FLOAT] = &&lt_float_float,
+                        [TYPE_FLOAT] = &&quicken_float_float,
+                        [TYPE_BIGINT] = &&lt_float_big,
+                },
+                [TYPE_BIGINT] = {
+                        [TYPE_INT] = &&lt_big,
+                        [TYPE_BOOL] = &&lt_big,
+                        [TYPE_BIGINT] = &&lt_big,
+                        [TYPE_FLOAT] = &&lt_big_float,
                 },
         };
 
-        Object opA = interpretExpression(root->operands[0].nd, ns);
-        ERROR_GUARD(opA);
-        Object opB = interpretExpression(root->operands[1].nd, ns);
-        ERROR_GUARD(opB);
         {
-                const void* handler = dispatcher[opA.type][opB.type];
+                const void* handler = dispatcher[OBJ_TYPE(opA)][OBJ_TYPE(opB)];
                 if (handler == NULL) goto error; // undefined array members are initialized to NULL (C99)
                 else goto *handler;
         }
 
+        quicken_int_int:
+        quicken(root, OP_LT_INT_INT);
         lt_int_int:
-        return (Object) {.type=TYPE_BOOL, .intval=(opA.intval<opB.intval)};
+        return OBJ_BOOL(AS_INT(opA)<AS_INT(opB));
+
+        lt_big:
+        return OBJ_BOOL(bigint_compare(opA, opB) < 0);
+
+        lt_big_float:
+        return OBJ_BOOL(bigint_to_double(opA)<AS_FLOAT(opB));
+
+        lt_float_big:
+        return OBJ_BOOL(AS_FLOAT(opA)<bigint_to_double(opB));
 
         lt_int_float:
-        return (Object) {.type=TYPE_BOOL, .intval=(opA.intval<opB.floatval)};
+        return OBJ_BOOL(AS_INT(opA)<AS_FLOAT(opB));
 
         lt_float_int:
-        return (Object) {.type=TYPE_BOOL, .intval=(opA.floatval<opB.intval)};
+        return OBJ_BOOL(AS_FLOAT(opA)<AS_INT(opB));
 
-        lt_float_float:
-        return (Object) {.type=TYPE_BOOL, .intval=(opA.floatval<opB.floatval)};
+        quicken_float_float:
+        quicken(root, OP_LT_FLOAT_FLOAT);
+        return OBJ_BOOL(AS_FLOAT(opA)<AS_FLOAT(opB));
 
         error:
         Error(&(root->token), "TypeError: can't compare ___ with ___.\n");
         return ERROR;
 }
-static Object interpretLe(const Node* root, Namespace *const ns) {
+static Object interpretLt(const Node* root, Namespace *const ns) {
+        Object opA = interpretExpression(root->operands[0].nd, ns);
+        ERROR_GUARD(opA);
+        Object opB = interpretRooted(root->operands[1].nd, ns, opA);
+        ERROR_GUARD(opB);
+        return applyLt(root, opA, opB);
+}
+static Object applyLe(const Node* root, const Object opA, const Object opB) {
         static const void* dispatcher[LEN_OBJTYPES][LEN_OBJTYPES] = {
                 [TYPE_INT] = {
-                        [TYPE_INT] = &&le_int_int,
+                        [TYPE_INT] = &&quicken_int_int,
                         [TYPE_BOOL] = &&le_int_int,
                         [TYPE_FLOAT] = &&le_int_float,
+                        [TYPE_BIGINT] = &&le_big,
                 },
                 [TYPE_BOOL] = {
                         [TYPE_INT] = &&le_int_int,
                         [TYPE_BOOL] = &&le_int_int,
                         [TYPE_FLOAT] = &&le_int_float,
+                        [TYPE_BIGINT] = &&le_big,
                 },
                 [TYPE_FLOAT] = {
                         [TYPE_INT] = &&le_float_int,
                         [TYPE_BOOL] = &&le_float_int,
-                        [TYPE_FLOAT] = &&le_float_float,
+                        [TYPE_FLOAT] = &&quicken_float_float,
+                        [TYPE_BIGINT] = &&le_float_big,
+                },
+                [TYPE_BIGINT] = {
+                        [TYPE_INT] = &&le_big,
+                        [TYPE_BOOL] = &&le_big,
+                        [TYPE_BIGINT] = &&le_big,
+                        [TYPE_FLOAT] = &&le_big_float,
                 },
         };
 
-        Object opA = interpretExpression(root->operands[0].nd, ns);
-        ERROR_GUARD(opA);
-        Object opB = interpretExpression(root->operands[1].nd, ns);
-        ERROR_GUARD(opB);
         {
-                const void* handler = dispatcher[opA.type][opB.type];
+                const void* handler = dispatcher[OBJ_TYPE(opA)][OBJ_TYPE(opB)];
                 if (handler == NULL) goto error; // undefined array members are initialized to NULL (C99)
                 else goto *handler;
         }
 
+        quicken_int_int:
+        quicken(root, OP_LE_INT_INT);
         le_int_int:
-        return (Object) {.type=TYPE_BOOL, .intval=(opA.intval<=opB.intval)};
+        return OBJ_BOOL(AS_INT(opA)<=AS_INT(opB));
+
+        le_big:
+        return OBJ_BOOL(bigint_compare(opA, opB) <= 0);
+
+        le_big_float:
+        return OBJ_BOOL(bigint_to_double(opA)<=AS_FLOAT(opB));
+
+        le_float_big:
+        return OBJ_BOOL(AS_FLOAT(opA)<=bigint_to_double(opB));
 
         le_int_float:
-        return (Object) {.type=TYPE_BOOL, .intval=(opA.intval<=opB.floatval)};
+        return OBJ_BOOL(AS_INT(opA)<=AS_FLOAT(opB));
 
         le_float_int:
-        return (Object) {.type=TYPE_BOOL, .intval=(opA.floatval<=opB.intval)};
+        return OBJ_BOOL(AS_FLOAT(opA)<=AS_INT(opB));
 
-        le_float_float:
-        return (Object) {.type=TYPE_BOOL, .intval=(opA.floatval<=opB.floatval)};
+        quicken_float_float:
+        quicken(root, OP_LE_FLOAT_FLOAT);
+        return OBJ_BOOL(AS_FLOAT(opA)<=AS_FLOAT(opB));
 
         error:
         Error(&(root->token), "TypeError: can't compare ___ with ___.\n");
         return ERROR;
 }
-static Object interpretCall(const Node* root, Namespace *const ns) {
+static Object interpretLe(const Node* root, Namespace *const ns) {
+        Object opA = interpretExpression(root->operands[0].nd, ns);
+        ERROR_GUARD(opA);
+        Object opB = interpretRooted(root->operands[1].nd, ns, opA);
+        ERROR_GUARD(opB);
+        return applyLe(root, opA, opB);
+}
+static size_t evaluateCall(const Node* root, Namespace *const ns) {
+        // pushes the callee, then its arguments on the evaluation stack
+        // returns the index of the callee, or SIZE_MAX on error (nothing is left on the stack then)
         Object funcnode = interpretExpression(root->operands[1].nd, ns);
-        ERROR_GUARD(funcnode);
-        switch (funcnode.type) {
-                case TYPE_NATIVEF:
-                {
-                        const uintptr_t argc = root->operands[0].len-1;
-
-                        Object *const argv = alloca(argc*sizeof(Object));
-                        for (uintptr_t iarg=0; iarg<argc; iarg++) {
-                                argv[iarg] = interpretExpression(root->operands[iarg+2].nd, ns);
-                                ERROR_GUARD(argv[iarg]);
-                        }
-                        Object result = funcnode.natfunval(argc, argv);
-                        if (result.type == TYPE_ERROR) Error(&(root->token), "Fatal error during call.\n");
-                        return result;
-                }
-                case TYPE_USERF: {
-                        const uintptr_t argc = funcnode.funval->arity;
-                        if (argc != root->operands[0].len-1) {
-                                Error(&(root->token), "ArityError: expected %lu parameters, got %lu\n.", argc, root->operands[0].len-1);
-                                return ERROR;
-                        }
+        if (OBJ_TYPE(funcnode) == TYPE_ERROR) return SIZE_MAX;
 
-                        size_t ns_len = pushNamespace(ns);
-                        for (uintptr_t iarg=0; iarg<argc; iarg++) {
-                                char* key = funcnode.funval->arguments[iarg];
-                                Object value = interpretExpression(root->operands[iarg+2].nd, ns);
-                                ERROR_GUARD(value);
-                                ns_set_value(ns, key, value);
-                        }
-                        const errcode code = _interpretStatement(funcnode.funval->body, ns);
-                        popNamespace(ns, ns_len);
-
-                        switch (code) {
-                                case OK_OK:
-                                return OBJ_NONE;
-                                case OK_ABORT:
-                                return ns->staging;
-                                case ERROR_ABORT:
-                                return ERROR;
-                        }
+        const size_t mark = ns_push(ns, funcnode);
+        const uintptr_t argc = root->operands[0].len-1;
+
+        if (OBJ_TYPE(funcnode) == TYPE_USERF && AS_USERF(funcnode)->arity != argc) {
+                Error(&(root->token), "ArityError: expected %lu parameters, got %lu\n.", AS_USERF(funcnode)->arity, argc);
+                ns->stack_top = mark;
+                return SIZE_MAX;
+        }
+        if (OBJ_TYPE(funcnode) != TYPE_USERF && OBJ_TYPE(funcnode) != TYPE_NATIVEF) {
+                Error(&(root->token), "TypeError: can't call a non-function.\n");
+                ns->stack_top = mark;
+                return SIZE_MAX;
+        }
+
+        // arguments are evaluated in the caller's frame
+        for (uintptr_t iarg=0; iarg<argc; iarg++) {
+                const Object value = interpretExpression(root->operands[iarg+2].nd, ns);
+                if (OBJ_TYPE(value) == TYPE_ERROR) {
+                        ns->stack_top = mark;
+                        return SIZE_MAX;
                 }
+                ns_push(ns, value);
+        }
+        return mark;
+}
+static Object callValues(const Node* root, Namespace *const ns, const size_t mark) {
+        // runs the call prepared by evaluateCall, then pops it
+        Object funcnode = ns->stack[mark];
+        const uintptr_t argc = root->operands[0].len-1;
+
+        if (OBJ_TYPE(funcnode) == TYPE_NATIVEF) {
+                Object result = AS_NATIVEF(funcnode)(argc, &(ns->stack[mark+1]));
+                ns->stack_top = mark;
+                if (OBJ_TYPE(result) == TYPE_ERROR) Error(&(root->token), "Fatal error during call.\n");
+                return result;
+        }
+
+        ObjFunction* function = AS_USERF(funcnode);
+        if (profiling) profile_call(root, function);
+        const size_t ns_len = pushNamespace(ns, function, &(ns->stack[mark+1]), argc);
+        errcode code;
+        for (;;) {
+                ns->stack_top = mark+1; // keep the callee alive, though
+
+                code = _interpretStatement(function->body, ns);
+                if (code != TAIL_CALL) break;
+
+                // the tail call left its callee and arguments on top of the evaluation stack:
+                // slide them down in place of ours, and run the callee in our frame
+                function = AS_USERF(ns->staging);
+                const size_t nb_values = function->arity + 1;
+                memmove(&(ns->stack[mark]), &(ns->stack[ns->stack_top-nb_values]), nb_values*sizeof(ns->stack[0]));
+                reuseNamespace(ns, function, &(ns->stack[mark+1]), function->arity);
+        }
+        popNamespace(ns, ns_len);
+        ns->stack_top = mark;
+        if (profiling) profile_return();
+
+        switch (code) {
+                case OK_OK:
+                return OBJ_NONE;
+                case OK_ABORT:
+                return ns->staging;
+                case ERROR_ABORT:
                 default:
-                        Error(&(root->token), "TypeError: can't call a non-function.\n");
-                        return ERROR;
+                return ERROR;
         }
 }
-static Object interpret_iadd(const Node* root, Namespace *const ns) {
+static Object interpretCall(const Node* root, Namespace *const ns) {
+        const size_t mark = evaluateCall(root, ns);
+        if (mark == SIZE_MAX) return ERROR;
+        return callValues(root, ns, mark);
+}
+static Object apply_iadd(const Node* root, Object *const target, const Object increment) {
         static const void* dispatcher[LEN_OBJTYPES][LEN_OBJTYPES] =  {
                 [TYPE_INT] = {
-                        [TYPE_INT] = &&add_int_int,
+                        [TYPE_INT] = &&quicken_int_int,
                         [TYPE_BOOL] = &&add_int_int,
                         [TYPE_FLOAT] = &&add_int_float,
+                        [TYPE_BIGINT] = &&add_big,
                 },
                 [TYPE_BOOL] = {
                         [TYPE_INT] = &&add_int_int,
                         [TYPE_BOOL] = &&add_int_int,
                         [TYPE_FLOAT] = &&add_int_float,
+                        [TYPE_BIGINT] = &&add_big,
                 },
                 [TYPE_FLOAT] = {
                         [TYPE_INT] = &&add_float_int,
                         [TYPE_BOOL] = &&add_float_int,
-                        [TYPE_FLOAT] = &&add_float_float,
+                        [TYPE_FLOAT] = &&quicken_float_float,
+                        [TYPE_BIGINT] = &&add_float_big,
                 },
                 [TYPE_STRING] = {
                         [TYPE_STRING] = &&add_string_string,
                 },
+                [TYPE_BIGINT] = {
+                        [TYPE_INT] = &&add_big,
+                        [TYPE_BOOL] = &&add_big,
+                        [TYPE_BIGINT] = &&add_big,
+                        [TYPE_FLOAT] = &&add_big_float,
+                },
         };
 
-        Object* target = ns_get_rw_value(ns, root->operands[0].nd->token.tok.source);
-        if (target == NULL) {
-                Error(&(root->operands[0].nd->token), "Undefined variable.\n");
-                return ERROR;
-        }
-
-        Object increment = interpretExpression(root->operands[1].nd, ns);
-        ERROR_GUARD(increment);
 
         {
-                const void* handler = dispatcher[target->type][increment.type];
+                const void* handler = dispatcher[OBJ_TYPE(*target)][OBJ_TYPE(increment)];
                 if (handler == NULL) goto error; // undefined array members are initialized to NULL (C99)
                 else goto *handler;
         }
 
+        quicken_int_int:
+        quicken(root, OP_IADD_INT_INT);
         add_int_int:
-        target->intval += increment.intval;
+        *target = int_add(*target, increment);
+        return *target;
+
+        add_big:
+        *target = bigint_add(*target, increment);
+        return *target;
+
+        add_big_float:
+        *target = OBJ_FLOAT(bigint_to_double(*target) + AS_FLOAT(increment));
+        return *target;
+
+        add_float_big:
+        *target = OBJ_FLOAT(AS_FLOAT(*target) + bigint_to_double(increment));
         return *target;
 
         add_int_float:
-        target->floatval = target->intval + increment.floatval;
-        target->type = TYPE_FLOAT;
+        *target = OBJ_FLOAT(AS_INT(*target) + AS_FLOAT(increment));
         return *target;
 
         add_string_string:
-        target->strval = concatenateStrings(target->strval, increment.strval);
+        *target = OBJ_STRING(concatenateStrings(AS_STRING(*target), AS_STRING(increment)));
         return *target;
 
         add_float_int:
-        target->floatval += increment.intval;
+        *target = OBJ_FLOAT(AS_FLOAT(*target) + AS_INT(increment));
         return *target;
 
-        add_float_float:
-        target->floatval += increment.floatval;
+        quicken_float_float:
+        quicken(root, OP_IADD_FLOAT_FLOAT);
+        *target = OBJ_FLOAT(AS_FLOAT(*target) + AS_FLOAT(increment));
         return *target;
 
 
         // actually already done thanks to *pointers*
         // success:
-        // ns_set_value(ns, root->operands[0].nd->token.tok.source, *target);
+        // ns_set_value(ns, root->operands[0].nd->operands[1].addr, *target);
 
         error:
         Error(&(root->token), "TypeError: ___+=___ is illegal.\n");
         return ERROR;
 }
-static Object interpret_isub(const Node* root, Namespace *const ns) {
+static Object interpret_iadd(const Node* root, Namespace *const ns) {
+        Object increment = interpretExpression(root->operands[1].nd, ns);
+        ERROR_GUARD(increment);
+
+        // fetched last: evaluating the increment may move the value stack around
+        Object* target = getVariable(root->operands[0].nd, ns);
+        if (target == NULL) return ERROR;
+
+        return apply_iadd(root, target, increment);
+}
+static Object apply_isub(const Node* root, Object *const target, const Object increment) {
         static const void* dispatcher[LEN_OBJTYPES][LEN_OBJTYPES] =  {
                 [TYPE_INT] = {
-                        [TYPE_INT] = &&sub_int_int,
+                        [TYPE_INT] = &&quicken_int_int,
                         [TYPE_BOOL] = &&sub_int_int,
                         [TYPE_FLOAT] = &&sub_int_float,
+                        [TYPE_BIGINT] = &&sub_big,
                 },
                 [TYPE_BOOL] = {
                         [TYPE_INT] = &&sub_int_int,
                         [TYPE_BOOL] = &&sub_int_int,
                         [TYPE_FLOAT] = &&sub_int_float,
+                        [TYPE_BIGINT] = &&sub_big,
                 },
                 [TYPE_FLOAT] = {
                         [TYPE_INT] = &&sub_float_int,
                         [TYPE_BOOL] = &&sub_float_int,
-                        [TYPE_FLOAT] = &&sub_float_float,
+                        [TYPE_FLOAT] = &&quicken_float_float,
+                        [TYPE_BIGINT] = &&sub_float_big,
+                },
+                [TYPE_BIGINT] = {
+                        [TYPE_INT] = &&sub_big,
+                        [TYPE_BOOL] = &&sub_big,
+                        [TYPE_BIGINT] = &&sub_big,
+                        [TYPE_FLOAT] = &&sub_big_float,
                 },
         };
 
-        Object* target = ns_get_rw_value(ns, root->operands[0].nd->token.tok.source);
-        if (target == NULL) {
-                Error(&(root->operands[0].nd->token), "Undefined variable.\n");
-                return ERROR;
-        }
-
-        Object increment = interpretExpression(root->operands[1].nd, ns);
-        ERROR_GUARD(increment);
 
         {
-                const void* handler = dispatcher[target->type][increment.type];
+                const void* handler = dispatcher[OBJ_TYPE(*target)][OBJ_TYPE(increment)];
                 if (handler == NULL) goto error; // undefined array members are initialized to NULL (C99)
                 else goto *handler;
         }
 
+        quicken_int_int:
+        quicken(root, OP_ISUB_INT_INT);
         sub_int_int:
-        target->intval -= increment.intval;
+        *target = int_sub(*target, increment);
+        return *target;
+
+        sub_big:
+        *target = bigint_sub(*target, increment);
+        return *target;
+
+        sub_big_float:
+        *target = OBJ_FLOAT(bigint_to_double(*target) - AS_FLOAT(increment));
+        return *target;
+
+        sub_float_big:
+        *target = OBJ_FLOAT(AS_FLOAT(*target) - bigint_to_double(increment));
         return *target;
 
         sub_int_float:
-        target->floatval = target->intval - increment.floatval;
-        target->type = TYPE_FLOAT;
+        *target = OBJ_FLOAT(AS_INT(*target) - AS_FLOAT(increment));
         return *target;
 
         sub_float_int:
-        target->floatval -= increment.intval;
+        *target = OBJ_FLOAT(AS_FLOAT(*target) - AS_INT(increment));
         return *target;
 
-        sub_float_float:
-        target->floatval -= increment.floatval;
+        quicken_float_float:
+        quicken(root, OP_ISUB_FLOAT_FLOAT);
+        *target = OBJ_FLOAT(AS_FLOAT(*target) - AS_FLOAT(increment));
         return *target;
 
 
         // actually already done thanks to *pointers*
         // success:
-        // ns_set_value(ns, root->operands[0].nd->token.tok.source, *target);
+        // ns_set_value(ns, root->operands[0].nd->operands[1].addr, *target);
 
         error:
         Error(&(root->token), "TypeError: ___-=___ is illegal.\n");
         return ERROR;
 }
-static Object interpret_imul(const Node* root, Namespace *const ns) {
+static Object interpret_isub(const Node* root, Namespace *const ns) {
+        Object increment = interpretExpression(root->operands[1].nd, ns);
+        ERROR_GUARD(increment);
+
+        // fetched last: evaluating the increment may move the value stack around
+        Object* target = getVariable(root->operands[0].nd, ns);
+        if (target == NULL) return ERROR;
+
+        return apply_isub(root, target, increment);
+}
+static Object apply_imul(const Node* root, Object *const target, const Object increment) {
         static const void* dispatcher[LEN_OBJTYPES][LEN_OBJTYPES] =  {
                 [TYPE_INT] = {
                         [TYPE_INT] = &&mul_int_int,
                         [TYPE_BOOL] = &&mul_int_int,
                         [TYPE_FLOAT] = &&mul_int_float,
                         [TYPE_STRING] = &&mul_int_string,
+                        [TYPE_BIGINT] = &&mul_big,
                 },
                 [TYPE_BOOL] = {
                         [TYPE_INT] = &&mul_int_int,
                         [TYPE_BOOL] = &&mul_int_int,
                         [TYPE_FLOAT] = &&mul_int_float,
                         [TYPE_STRING] = &&mul_int_string,
+                        [TYPE_BIGINT] = &&mul_big,
                 },
                 [TYPE_FLOAT] = {
                         [TYPE_INT] = &&mul_float_int,
                         [TYPE_BOOL] = &&mul_float_int,
                         [TYPE_FLOAT] = &&mul_float_float,
+                        [TYPE_BIGINT] = &&mul_float_big,
                 },
                 [TYPE_STRING] = {
                         [TYPE_INT] = &&mul_string_int,
                         [TYPE_BOOL] = &&mul_string_int,
                 },
+                [TYPE_BIGINT] = {
+                        [TYPE_INT] = &&mul_big,
+                        [TYPE_BOOL] = &&mul_big,
+                        [TYPE_BIGINT] = &&mul_big,
+                        [TYPE_FLOAT] = &&mul_big_float,
+                },
         };
 
-        Object* target = ns_get_rw_value(ns, root->operands[0].nd->token.tok.source);
-        if (target == NULL) {
-                Error(&(root->operands[0].nd->token), "Undefined variable.\n");
-                return ERROR;
-        }
-
-        Object increment = interpretExpression(root->operands[1].nd, ns);
-        ERROR_GUARD(increment);
 
         {
-                const void* handler = dispatcher[target->type][increment.type];
+                const void* handler = dispatcher[OBJ_TYPE(*target)][OBJ_TYPE(increment)];
                 if (handler == NULL) goto error; // undefined array members are initialized to NULL (C99)
                 else goto *handler;
         }
 
         mul_int_string:
-        if (target->intval < 0) goto error;
-        target->strval = multiplyString(increment.strval, target->intval);
-        target->type = TYPE_STRING;
+        if (AS_INT(*target) < 0) goto error;
+        *target = OBJ_STRING(multiplyString(AS_STRING(increment), AS_INT(*target)));
         return *target;
 
         mul_string_int:
-        if (increment.intval < 0) goto error;
-        target->strval = multiplyString(target->strval, increment.intval);
+        if (AS_INT(increment) < 0) goto error;
+        *target = OBJ_STRING(multiplyString(AS_STRING(*target), AS_INT(increment)));
         return *target;
 
         mul_int_int:
-        target->intval *= increment.intval;
+        *target = int_mul(*target, increment);
+        return *target;
+
+        mul_big:
+        *target = bigint_mul(*target, increment);
+        return *target;
+
+        mul_big_float:
+        *target = OBJ_FLOAT(bigint_to_double(*target) * AS_FLOAT(increment));
+        return *target;
+
+        mul_float_big:
+        *target = OBJ_FLOAT(AS_FLOAT(*target) * bigint_to_double(increment));
         return *target;
 
         mul_int_float:
-        target->floatval = target->intval * increment.floatval;
-        target->type = TYPE_FLOAT;
+        *target = OBJ_FLOAT(AS_INT(*target) * AS_FLOAT(increment));
         return *target;
 
         mul_float_int:
-        target->floatval *= increment.intval;
+        *target = OBJ_FLOAT(AS_FLOAT(*target) * AS_INT(increment));
         return *target;
 
         mul_float_float:
-        target->floatval *= increment.floatval;
+        *target = OBJ_FLOAT(AS_FLOAT(*target) * AS_FLOAT(increment));
         return *target;
 
 
         // actually already done thanks to *pointers*
         // success:
-        // ns_set_value(ns, root->operands[0].nd->token.tok.source, *target);
+        // ns_set_value(ns, root->operands[0].nd->operands[1].addr, *target);
 
         error:
         Error(&(root->token), "TypeError: ___*=___ is illegal.\n");
         return ERROR;
 }
-static Object interpret_idiv(const Node* root, Namespace *const ns) {
+static Object interpret_imul(const Node* root, Namespace *const ns) {
+        Object increment = interpretExpression(root->operands[1].nd, ns);
+        ERROR_GUARD(increment);
+
+        // fetched last: evaluating the increment may move the value stack around
+        Object* target = getVariable(root->operands[0].nd, ns);
+        if (target == NULL) return ERROR;
+
+        return apply_imul(root, target, increment);
+}
+static Object apply_idiv(const Node* root, Object *const target, const Object increment) {
         static const void* dispatcher[LEN_OBJTYPES][LEN_OBJTYPES] =  {
                 [TYPE_INT] = {
                         [TYPE_INT] = &&div_int_int,
                         [TYPE_BOOL] = &&div_int_int,
                         [TYPE_FLOAT] = &&div_int_float,
+                        [TYPE_BIGINT] = &&div_big,
                 },
                 [TYPE_BOOL] = {
                         [TYPE_INT] = &&div_int_int,
                         [TYPE_BOOL] = &&div_int_int,
                         [TYPE_FLOAT] = &&div_int_float,
+                        [TYPE_BIGINT] = &&div_big,
                 },
                 [TYPE_FLOAT] = {
                         [TYPE_INT] = &&div_float_int,
                         [TYPE_BOOL] = &&div_float_int,
                         [TYPE_FLOAT] = &&div_float_float,
+                        [TYPE_BIGINT] = &&div_float_big,
+                },
+                [TYPE_BIGINT] = {
+                        [TYPE_INT] = &&div_big,
+                        [TYPE_BOOL] = &&div_big,
+                        [TYPE_BIGINT] = &&div_big,
+                        [TYPE_FLOAT] = &&div_big_float,
                 },
         };
 
-        Object* target = ns_get_rw_value(ns, root->operands[0].nd->token.tok.source);
-        if (target == NULL) {
-                Error(&(root->operands[0].nd->token), "Undefined variable.\n");
-                return ERROR;
-        }
-
-        Object increment = interpretExpression(root->operands[1].nd, ns);
-        ERROR_GUARD(increment);
 
         {
-                const void* handler = dispatcher[target->type][increment.type];
+                const void* handler = dispatcher[OBJ_TYPE(*target)][OBJ_TYPE(increment)];
                 if (handler == NULL) goto error; // undefined array members are initialized to NULL (C99)
                 else goto *handler;
         }
 
         div_int_int:
-        target->intval /= increment.intval;
+        if (AS_INT(increment) == 0) {
+                Error(&(root->token), "ZeroDivisionError: integer ___/=0 is illegal.\n");
+                return ERROR;
+        }
+        *target = int_div(*target, increment);
+        return *target;
+
+        div_big:
+        *target = OBJ_FLOAT(bigint_div(*target, increment));
+        return *target;
+
+        div_big_float:
+        *target = OBJ_FLOAT(bigint_to_double(*target) / AS_FLOAT(increment));
+        return *target;
+
+        div_float_big:
+        *target = OBJ_FLOAT(AS_FLOAT(*target) / bigint_to_double(increment));
         return *target;
 
         div_int_float:
-        target->floatval = target->intval / increment.floatval;
-        target->type = TYPE_FLOAT;
+        *target = OBJ_FLOAT(AS_INT(*target) / AS_FLOAT(increment));
         return *target;
 
         div_float_int:
-        target->floatval /= increment.intval;
+        *target = OBJ_FLOAT(AS_FLOAT(*target) / AS_INT(increment));
         return *target;
 
         div_float_float:
-        target->floatval /= increment.floatval;
+        *target = OBJ_FLOAT(AS_FLOAT(*target) / AS_FLOAT(increment));
         return *target;
 
 
         // actually already done thanks to *pointers*
         // success:
-        // ns_set_value(ns, root->operands[0].nd->token.tok.source, *target);
+        // ns_set_value(ns, root->operands[0].nd->operands[1].addr, *target);
 
         error:
         Error(&(root->token), "TypeError: ___/=___ is illegal.\n");
         return ERROR;
 }
 
+static Object interpret_idiv(const Node* root, Namespace *const ns) {
+        Object increment = interpretExpression(root->operands[1].nd, ns);
+        ERROR_GUARD(increment);
+
+        // fetched last: evaluating the increment may move the value stack around
+        Object* target = getVariable(root->operands[0].nd, ns);
+        if (target == NULL) return ERROR;
+
+        return apply_idiv(root, target, increment);
+}
+/*
+Quickened operators: a generic node rewrites itself into one of these after
+seeing operands of the matching types, which saves the dispatch table lookup
+on the next evaluations. On a type mismatch, the node goes back to its
+generic operator.
+*/
+#define QUICKENED_BINARY(name, generic, apply, type, result) \
+static Object name(const Node* root, Namespace *const ns) { \
+        const Object opA = interpretExpression(root->operands[0].nd, ns); \
+        ERROR_GUARD(opA); \
+        const Object opB = interpretRooted(root->operands[1].nd, ns, opA); \
+        ERROR_GUARD(opB); \
+        if (OBJ_TYPE(opA) != type || OBJ_TYPE(opB) != type) return apply(quicken(root, generic), opA, opB); \
+        return result; \
+}
+#define QUICKENED_INPLACE(name, generic, apply, type, result) \
+static Object name(const Node* root, Namespace *const ns) { \
+        const Object increment = interpretExpression(root->operands[1].nd, ns); \
+        ERROR_GUARD(increment); \
+        Object *const target = getVariable(root->operands[0].nd, ns); \
+        if (target == NULL) return ERROR; \
+        if (OBJ_TYPE(*target) != type || OBJ_TYPE(increment) != type) return apply(quicken(root, generic), target, increment); \
+        *target = result; \
+        return *target; \
+}
+
+QUICKENED_BINARY(interpretSumIntInt, OP_SUM, applySum, TYPE_INT, int_add(opA, opB))
+QUICKENED_BINARY(interpretSumFloatFloat, OP_SUM, applySum, TYPE_FLOAT, OBJ_FLOAT(AS_FLOAT(opA)+AS_FLOAT(opB)))
+QUICKENED_BINARY(interpretDifferenceIntInt, OP_DIFFERENCE, applyDifference, TYPE_INT, int_sub(opA, opB))
+QUICKENED_BINARY(interpretDifferenceFloatFloat, OP_DIFFERENCE, applyDifference, TYPE_FLOAT, OBJ_FLOAT(AS_FLOAT(opA)-AS_FLOAT(opB)))
+QUICKENED_BINARY(interpretProductIntInt, OP_PRODUCT, applyProduct, TYPE_INT, int_mul(opA, opB))
+QUICKENED_BINARY(interpretProductFloatFloat, OP_PRODUCT, applyProduct, TYPE_FLOAT, OBJ_FLOAT(AS_FLOAT(opA)*AS_FLOAT(opB)))
+QUICKENED_BINARY(interpretDivisionFloatFloat, OP_DIVISION, applyDivision, TYPE_FLOAT, OBJ_FLOAT(AS_FLOAT(opA)/AS_FLOAT(opB)))
+QUICKENED_BINARY(interpretEqIntInt, OP_EQ, applyEq, TYPE_INT, OBJ_BOOL(AS_INT(opA)==AS_INT(opB)))
+QUICKENED_BINARY(interpretLtIntInt, OP_LT, applyLt, TYPE_INT, OBJ_BOOL(AS_INT(opA)<AS_INT(opB)))
+QUICKENED_BINARY(interpretLtFloatFloat, OP_LT, applyLt, TYPE_FLOAT, OBJ_BOOL(AS_FLOAT(opA)<AS_FLOAT(opB)))
+QUICKENED_BINARY(interpretLeIntInt, OP_LE, applyLe, TYPE_INT, OBJ_BOOL(AS_INT(opA)<=AS_INT(opB)))
+QUICKENED_BINARY(interpretLeFloatFloat, OP_LE, applyLe, TYPE_FLOAT, OBJ_BOOL(AS_FLOAT(opA)<=AS_FLOAT(opB)))
+QUICKENED_INPLACE(interpret_iadd_int_int, OP_IADD, apply_iadd, TYPE_INT, int_add(*target, increment))
+QUICKENED_INPLACE(interpret_iadd_float_float, OP_IADD, apply_iadd, TYPE_FLOAT, OBJ_FLOAT(AS_FLOAT(*target)+AS_FLOAT(increment)))
+QUICKENED_INPLACE(interpret_isub_int_int, OP_ISUB, apply_isub, TYPE_INT, int_sub(*target, increment))
+QUICKENED_INPLACE(interpret_isub_float_float, OP_ISUB, apply_isub, TYPE_FLOAT, OBJ_FLOAT(AS_FLOAT(*target)-AS_FLOAT(increment)))
+
+#undef QUICKENED_BINARY
+#undef QUICKENED_INPLACE
+
 static errcode interpretBlock(const Node* root, Namespace *const ns) {
         const uintptr_t nb_children = root->operands[0].len;
 
@@ -809,69 +1209,191 @@ static errcode interpretBlock(const Node* root, Namespace *const ns) {
 static errcode interpretIf(const Node* root, Namespace *const ns) {
         Object predicate = interpretExpression(root->operands[0].nd, ns);
         predicate = tobool(1, &predicate);
-        if (predicate.type == TYPE_ERROR) return ERROR_ABORT;
-        if (predicate.intval) return _interpretStatement(root->operands[1].nd, ns);
+        if (OBJ_TYPE(predicate) == TYPE_ERROR) return ERROR_ABORT;
+        if (AS_INT(predicate)) return _interpretStatement(root->operands[1].nd, ns);
         else if (root->operands[2].nd != NULL) return _interpretStatement(root->operands[2].nd, ns);
         else return OK_OK;
 }
+static int resumeWithin(const Node* root, const Node* statement, Namespace *const ns, errcode *const status) {
+        // if <statement> is found in <root>, runs it, then what follows it in <root>
+        if (root == NULL) return 0;
+        if (root == statement) {
+                *status = _interpretStatement(root, ns);
+                return 1;
+        }
+        switch (root->operator) {
+                case OP_BLOCK:
+                        for (uintptr_t i=1; i<=root->operands[0].len; i++) {
+                                if (!resumeWithin(root->operands[i].nd, statement, ns, status)) continue;
+                                for (i++; i<=root->operands[0].len && *status == OK_OK; i++) {
+                                        *status = _interpretStatement(root->operands[i].nd, ns);
+                                }
+                                return 1;
+                        }
+                        return 0;
+                case OP_IFELSE:
+                        return resumeWithin(root->operands[1].nd, statement, ns, status)
+                                || resumeWithin(root->operands[2].nd, statement, ns, status);
+                case OP_WHILE:
+                        if (!resumeWithin(root->operands[1].nd, statement, ns, status)) return 0;
+                        if (*status == OK_OK) *status = _interpretStatement(root, ns);
+                        return 1;
+                default:
+                        return 0;
+        }
+}
+static int runCompiled(const Node* root, Namespace *const ns, errcode *const status) {
+        // returns 0 if the tree walker must go on with the loop, from its predicate
+        const Node *const resume = jit_run(root->operands[JIT_LOOP].jit, root, ns);
+        if (resume == NULL) {
+                *status = OK_OK;
+                return 1;
+        }
+        if (resume == root) return 0;
+
+        // the code bailed out in the middle of an iteration, which the tree walker completes
+        *status = OK_OK;
+        resumeWithin(root->operands[1].nd, resume, ns, status);
+        return *status != OK_OK;
+}
 static errcode interpretWhile(const Node* root, Namespace *const ns) {
+        Node *const loop = (Node*) root; // for the state of the JIT
+        errcode status;
+        if (loop->operands[JIT_LOOP].jit != NULL && runCompiled(root, ns, &status)) return status;
+
         Object predicate;
         while (
                 predicate = interpretExpression(root->operands[0].nd, ns),
                 predicate = tobool(1, &predicate),
-                predicate.type != TYPE_ERROR && predicate.intval
+                OBJ_TYPE(predicate) != TYPE_ERROR && AS_INT(predicate)
         ) {
                 errcode e = _interpretStatement(root->operands[1].nd, ns);
                 if (e != OK_OK) return e;
+
+                if (loop->operands[JIT_LOOP].jit == NULL && ++loop->operands[JIT_HOTNESS].len >= JIT_THRESHOLD && current_vm->jit_enabled) {
+                        loop->operands[JIT_LOOP].jit = jit_compile(root, ns);
+                        if (runCompiled(root, ns, &status)) return status;
+                }
         }
-        if (predicate.type == TYPE_ERROR) return ERROR_ABORT;
+        if (OBJ_TYPE(predicate) == TYPE_ERROR) return ERROR_ABORT;
         else return OK_OK;
 }
 static errcode interpretNop(const Node* root, Namespace *const ns) {
         return OK_OK;
 }
+static errcode interpretForget(const Node* root, Namespace *const ns) {
+        const uintptr_t nb_addresses = root->operands[0].len;
+        for (uintptr_t i=1; i<=nb_addresses; i++) ns_set_value(ns, root->operands[i].addr, ERROR);
+        return OK_OK;
+}
 static errcode interpret_return(const Node* root, Namespace *const ns) {
-        Object value = interpretExpression(root->operands[0].nd, ns);
-        if (value.type == TYPE_ERROR) return ERROR_ABORT;
+        const Node *const expression = root->operands[0].nd;
+        if (expression->operator == OP_CALL && ns->nb_frames > 1) {
+                // a tail call: if neither the callee nor a function created here need our frame, our caller may reuse it
+                const size_t mark = evaluateCall(expression, ns);
+                if (mark == SIZE_MAX) return ERROR_ABORT;
+                const Object callee = ns->stack[mark];
+                const Frame *const frame = &(ns->frames[ns->nb_frames-1]);
+                if (OBJ_TYPE(callee) == TYPE_USERF && AS_USERF(callee)->level <= frame->level && !frame->captured) {
+                        if (profiling) profile_tail_call(expression, AS_USERF(callee));
+                        ns->staging = callee;
+                        return TAIL_CALL;
+                }
+                const Object value = callValues(expression, ns, mark);
+                if (OBJ_TYPE(value) == TYPE_ERROR) return ERROR_ABORT;
+                ns->staging = value;
+                return OK_ABORT;
+        }
+
+        Object value = interpretExpression(expression, ns);
+        if (OBJ_TYPE(value) == TYPE_ERROR) return ERROR_ABORT;
         ns->staging = value;
         return OK_ABORT;
 }
 
+static const ExprInterpretFn expression_interpreters[LEN_OPERATORS] = {
+        [OP_VARIABLE] = interpretVariable,
+
+        [OP_LITERAL_FUNCTION] = interpretFunction,
+        [OP_LITERAL_INT] = interpretInt,
+        [OP_LITERAL_FLOAT] = interpretFloat,
+        [OP_LITERAL_TRUE] = interpretTrue,
+        [OP_LITERAL_FALSE] = interpretFalse,
+        [OP_LITERAL_NONE] = interpretNone,
+        [OP_LITERAL_STR] = interpretStr,
+
+        [OP_UNARY_PLUS] = interpretUnaryPlus,
+        [OP_UNARY_MINUS] = interpretUnaryMinus,
+        [OP_INVERT] = interpretInvert,
+        [OP_INVARIANT] = interpretInvariant,
+
+        [OP_SUM] = interpretSum,
+        [OP_DIFFERENCE] = interpretDifference,
+        [OP_PRODUCT] = interpretProduct,
+        [OP_DIVISION] = interpretDivision,
+        [OP_AFFECT] = interpretAffect,
+        [OP_AND] = interpretAnd,
+        [OP_OR] = interpretOr,
+        [OP_EQ] = interpretEq,
+        [OP_LT] = interpretLt,
+        [OP_LE] = interpretLe,
+        [OP_IADD] = interpret_iadd,
+        [OP_ISUB] = interpret_isub,
+        [OP_IMUL] = interpret_imul,
+        [OP_IDIV] = interpret_idiv,
+
+        [OP_CALL] = interpretCall,
+
+        [OP_SUM_INT_INT] = interpretSumIntInt,
+        [OP_SUM_FLOAT_FLOAT] = interpretSumFloatFloat,
+        [OP_DIFFERENCE_INT_INT] = interpretDifferenceIntInt,
+        [OP_DIFFERENCE_FLOAT_FLOAT] = interpretDifferenceFloatFloat,
+        [OP_PRODUCT_INT_INT] = interpretProductIntInt,
+        [OP_PRODUCT_FLOAT_FLOAT] = interpretProductFloatFloat,
+        [OP_DIVISION_FLOAT_FLOAT] = interpretDivisionFloatFloat,
+        [OP_EQ_INT_INT] = interpretEqIntInt,
+        [OP_LT_INT_INT] = interpretLtIntInt,
+        [OP_LT_FLOAT_FLOAT] = interpretLtFloatFloat,
+        [OP_LE_INT_INT] = interpretLeIntInt,
+        [OP_LE_FLOAT_FLOAT] = interpretLeFloatFloat,
+        [OP_IADD_INT_INT] = interpret_iadd_int_int,
+        [OP_IADD_FLOAT_FLOAT] = interpret_iadd_float_float,
+        [OP_ISUB_INT_INT] = interpret_isub_int_int,
+        [OP_ISUB_FLOAT_FLOAT] = interpret_isub_float_float,
+};
+/*
+With the profiler on, the dispatcher goes through this table instead, which
+wraps the same handlers; the plain path stays free of any check.
+*/
+static ExprInterpretFn profiled_interpreters[LEN_OPERATORS];
+static const ExprInterpretFn* dispatch_table = expression_interpreters;
+
+static Object profileExpression(const Node* root, Namespace *const ns) {
+        profile_enter(root);
+        const Object result = expression_interpreters[root->operator](root, ns);
+        profile_exit();
+        return result;
+}
+static void select_dispatch_table(void) {
+        // only written when the profiler is toggled, so that instances on other threads only ever read it
+        if (!profiling) {
+                if (dispatch_table != expression_interpreters) dispatch_table = expression_interpreters;
+                return;
+        }
+        for (size_t op=0; op<LEN_OPERATORS; op++) {
+                profiled_interpreters[op] = expression_interpreters[op] ? profileExpression : NULL;
+        }
+        dispatch_table = profiled_interpreters;
+}
+// out of line, so that it doesn't weigh on _interpretStatement
+__attribute__((noinline)) static errcode profileStatement(const StmtInterpretFn handler, const Node* root, Namespace *const ns) {
+        profile_enter(root);
+        const errcode status = handler(root, ns);
+        profile_exit();
+        return status;
+}
 static Object interpretExpression(const Node* root, Namespace *const ns) {
-        static const ExprInterpretFn interpreters[LEN_OPERATORS] = {
-                [OP_VARIABLE] = interpretVariable,
-
-                [OP_LITERAL_FUNCTION] = interpretFunction,
-                [OP_LITERAL_INT] = interpretInt,
-                [OP_LITERAL_FLOAT] = interpretFloat,
-                [OP_LITERAL_TRUE] = interpretTrue,
-                [OP_LITERAL_FALSE] = interpretFalse,
-                [OP_LITERAL_NONE] = interpretNone,
-                [OP_LITERAL_STR] = interpretStr,
-
-                [OP_UNARY_PLUS] = interpretUnaryPlus,
-                [OP_UNARY_MINUS] = interpretUnaryMinus,
-                [OP_INVERT] = interpretInvert,
-
-                [OP_SUM] = interpretSum,
-                [OP_DIFFERENCE] = interpretDifference,
-                [OP_PRODUCT] = interpretProduct,
-                [OP_DIVISION] = interpretDivision,
-                [OP_AFFECT] = interpretAffect,
-                [OP_AND] = interpretAnd,
-                [OP_OR] = interpretOr,
-                [OP_EQ] = interpretEq,
-                [OP_LT] = interpretLt,
-                [OP_LE] = interpretLe,
-                [OP_IADD] = interpret_iadd,
-                [OP_ISUB] = interpret_isub,
-                [OP_IMUL] = interpret_imul,
-                [OP_IDIV] = interpret_idiv,
-
-                [OP_CALL] = interpretCall,
-        };
-
-        const ExprInterpretFn handler = interpreters[root->operator];
+        const ExprInterpretFn handler = dispatch_table[root->operator];
         if (handler == NULL) {
                 Error(&(root->token), "Fatal error.\n");
                 return ERROR;
@@ -884,28 +1406,60 @@ static errcode _interpretStatement(const Node* root, Namespace *const ns) {
                 [OP_IFELSE] = interpretIf,
                 [OP_WHILE] = interpretWhile,
                 [OP_NOP] = interpretNop,
+                [OP_FORGET] = interpretForget,
                 [OP_RETURN] = interpret_return,
         };
 
         if (root == NULL) return OK_ABORT;
 
+        // statement boundaries are the safe points of the garbage collector
+        if (gc_pending()) collect_garbage(ns);
+
         StmtInterpretFn interpreter = interpreters[root->operator];
 
 
         if (interpreter == NULL) {
                 Object result = interpretExpression(root, ns);
-                if (result.type == TYPE_ERROR) return ERROR_ABORT;
+                if (OBJ_TYPE(result) == TYPE_ERROR) return ERROR_ABORT;
                 else return OK_OK;
         }
+        else if (__builtin_expect(profiling, 0)) {
+                return profileStatement(interpreter, root, ns);
+        }
         else {
-                return interpreters[root->operator](root, ns);
+                return interpreter(root, ns);
         }
 }
 
 errcode interpretStatement(interpreter_info *const interpinfo) {
         LOG("Interpreting a new statement");
-        Node* root = parse_statement(&(interpinfo->prsinfo));
+        select_dispatch_table();
+        Node* root = optimize(&(interpinfo->prsinfo), parse_statement(&(interpinfo->prsinfo)));
+        interpinfo->ns.statement = root;
         const errcode status = _interpretStatement(root, &(interpinfo->ns));
-        freeNode(root);
+        interpinfo->ns.statement = NULL;
+        return status;
+}
+errcode interpretProgram(interpreter_info *const interpinfo, const char* cache_path) {
+        parser_info *const prsinfo = &(interpinfo->prsinfo);
+        Node* program = NULL;
+        CacheKey key;
+
+        if (cache_path != NULL) {
+                key = cache_key(prsinfo->lxinfo.file);
+                program = load_cached_program(prsinfo, cache_path, key);
+        }
+        if (program == NULL) {
+                LOG("Parsing the whole program");
+                program = optimize(prsinfo, parse_program(prsinfo));
+                if (program == NULL) return ERROR_ABORT;
+                if (cache_path != NULL) store_cached_program(prsinfo, cache_path, key, program);
+        }
+
+        LOG("Interpreting the program");
+        select_dispatch_table();
+        interpinfo->ns.statement = program;
+        const errcode status = interpretBlock(program, &(interpinfo->ns));
+        interpinfo->ns.statement = NULL;
         return status;
 }
@@ -0,0 +1,594 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <alloca.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "interpreter/jit.h"
+#include "interpreter/object.h"
+#include "interpreter/vm.h"
+#include "error.h"
+
+typedef intptr_t (*JitEntry)(Object** slots);
+
+struct JitLoop {
+        JitEntry entry; // returns -1 once the loop is over, or the index of the statement to resume from
+        void* code;
+        size_t code_size;
+
+        // the variables the code reads and writes, through pointers to their slots
+        Address* variables;
+        ObjType* types;
+        size_t nb_variables;
+
+        const Node** resumes; // resumes[0] is the loop itself
+        size_t nb_resumes;
+
+        Address* invariants; // caches of hoisted expressions, that the code doesn't keep up to date
+        size_t nb_invariants;
+
+        int disabled;
+        JitLoop* next;
+};
+
+static JitLoop declined = {.disabled=1}; // shared by all instances, never written to
+
+static inline int has_type(const Object obj, const ObjType type) {
+#ifdef NAN_BOXING
+        // boxed ints are left to the tree walker
+        return (obj.bits & ~NANBOX_PAYLOAD) == NANBOX_TAG(type);
+#else
+        return OBJ_TYPE(obj) == type;
+#endif
+}
+
+#if defined(__x86_64__)
+
+/*
+The code is a plain stack machine: expressions leave their value in rax,
+binary operators get their right operand in rcx, and rbx points to the array
+of slot pointers. Ints and bools are kept untagged in registers.
+*/
+
+typedef enum Register {
+        RAX = 0,
+        RCX = 1,
+        RDX = 2,
+} Register;
+
+typedef struct Bailout {
+        size_t patch; // offset of the rel32 of the jump
+        size_t resume;
+} Bailout;
+
+typedef struct Compiler {
+        JitLoop* jit;
+        Namespace* ns;
+        uint8_t* code;
+        size_t len, capacity;
+        Bailout* bailouts;
+        size_t nb_bailouts, bailouts_capacity;
+        size_t variables_capacity, resumes_capacity, invariants_capacity;
+        size_t resume; // of the statement being compiled
+        int ok;
+} Compiler;
+
+#define GROW(array, len, capacity) do { \
+        if ((len) >= (capacity)) { \
+                (capacity) = (capacity) ? 2*(capacity) : 16; \
+                (array) = reallocarray((array), (capacity), sizeof((array)[0])); \
+        } \
+} while (0)
+
+// ------------------------------ emission -------------------------------------
+
+static void emit(Compiler *const c, const uint8_t* bytes, const size_t n) {
+        while (c->len + n > c->capacity) {
+                c->capacity = c->capacity ? 2*c->capacity : 1024;
+                c->code = realloc(c->code, c->capacity);
+        }
+        memcpy(c->code + c->len, bytes, n);
+        c->len += n;
+}
+#define EMIT(c, ...) emit((c), (const uint8_t[]) {__VA_ARGS__}, sizeof((const uint8_t[]) {__VA_ARGS__}))
+
+static void emit_u32(Compiler *const c, const uint32_t value) {
+        emit(c, (const uint8_t*) &value, sizeof(value));
+}
+static void emit_u64(Compiler *const c, const uint64_t value) {
+        emit(c, (const uint8_t*) &value, sizeof(value));
+}
+static size_t emit_jump(Compiler *const c, const uint8_t opcode) {
+        // a jcc (0F 8x) or a jmp (E9) whose target is patched later; returns where the rel32 is
+        if (opcode == 0xE9) EMIT(c, 0xE9);
+        else EMIT(c, 0x0F, opcode);
+        emit_u32(c, 0);
+        return c->len - 4;
+}
+static void patch(Compiler *const c, const size_t at, const size_t target) {
+        const int32_t rel = (int32_t) (target - (at + 4));
+        memcpy(c->code + at, &rel, sizeof(rel));
+}
+static void emit_jump_to(Compiler *const c, const uint8_t opcode, const size_t target) {
+        patch(c, emit_jump(c, opcode), target);
+}
+static void emit_bailout(Compiler *const c, const uint8_t opcode) {
+        // leaves the code on the given condition, right before the current statement
+        GROW(c->bailouts, c->nb_bailouts, c->bailouts_capacity);
+        c->bailouts[c->nb_bailouts++] = (Bailout) {.patch=emit_jump(c, opcode), .resume=c->resume};
+}
+
+#define JO 0x80
+#define JNE 0x85
+#define JE 0x84
+#define JG 0x8F
+#define JGE 0x8D
+#define JMP 0xE9
+
+static void emit_constant(Compiler *const c, const Register reg, const intmax_t value) {
+        if (value >= INT32_MIN && value <= INT32_MAX) {
+                EMIT(c, 0x48, 0xC7, 0xC0 | reg); // mov reg, imm32 (sign-extended)
+                emit_u32(c, (uint32_t) value);
+        }
+        else {
+                EMIT(c, 0x48, 0xB8 | reg); // mov reg, imm64
+                emit_u64(c, (uint64_t) value);
+        }
+}
+static void emit_slot_pointer(Compiler *const c, const size_t variable) {
+        EMIT(c, 0x48, 0x8B, 0x93); // mov rdx, [rbx + disp32]
+        emit_u32(c, variable*sizeof(Object*));
+}
+static void emit_load(Compiler *const c, const Register reg, const size_t variable) {
+        emit_slot_pointer(c, variable);
+#ifdef NAN_BOXING
+        EMIT(c, 0x48, 0x8B, 0x02 | reg << 3); // mov reg, [rdx]
+        EMIT(c, 0x48, 0xC1, 0xE0 | reg, 16); // shl reg, 16
+        EMIT(c, 0x48, 0xC1, 0xF8 | reg, 16); // sar reg, 16
+#else
+        EMIT(c, 0x48, 0x8B, 0x42 | reg << 3, offsetof(Object, intval)); // mov reg, [rdx + intval]
+#endif
+}
+static void emit_store(Compiler *const c, const size_t variable) {
+        // stores rax, whose type is that of the variable already
+        emit_slot_pointer(c, variable);
+#ifdef NAN_BOXING
+        if (c->jit->types[variable] == TYPE_INT) {
+                // the tree walker boxes the ints that don't fit in the payload
+                EMIT(c, 0x48, 0x89, 0xC1); // mov rcx, rax
+                EMIT(c, 0x48, 0xC1, 0xE1, 16); // shl rcx, 16
+                EMIT(c, 0x48, 0xC1, 0xF9, 16); // sar rcx, 16
+                EMIT(c, 0x48, 0x39, 0xC1); // cmp rcx, rax
+                emit_bailout(c, JNE);
+        }
+        emit_constant(c, RCX, NANBOX_PAYLOAD);
+        EMIT(c, 0x48, 0x21, 0xC8); // and rax, rcx
+        emit_constant(c, RCX, NANBOX_TAG(c->jit->types[variable]));
+        EMIT(c, 0x48, 0x09, 0xC8); // or rax, rcx
+        EMIT(c, 0x48, 0x89, 0x02); // mov [rdx], rax
+#else
+        EMIT(c, 0x48, 0x89, 0x42, offsetof(Object, intval)); // mov [rdx + intval], rax
+#endif
+}
+
+// ------------------------------ variables ------------------------------------
+
+static int same_address(const Address a, const Address b) {
+        return a.depth == b.depth && a.slot == b.slot;
+}
+static size_t variable_index(Compiler *const c, const Node* variable) {
+        // returns SIZE_MAX if the variable can't be used by compiled code
+        if (variable->operator != OP_VARIABLE || variable->operands[0].len == 0) return SIZE_MAX;
+
+        // the innermost address must be set, otherwise the tree walker could pick another one later
+        const Address addr = variable->operands[1].addr;
+        JitLoop *const jit = c->jit;
+        for (size_t i=0; i<jit->nb_variables; i++) if (same_address(jit->variables[i], addr)) return i;
+
+        const Object* value = ns_get_value(c->ns, addr);
+        if (value == NULL) return SIZE_MAX;
+        ObjType type;
+        if (has_type(*value, TYPE_INT)) type = TYPE_INT;
+        else if (has_type(*value, TYPE_BOOL)) type = TYPE_BOOL;
+        else return SIZE_MAX;
+
+        if (jit->nb_variables >= c->variables_capacity) {
+                // both arrays grow in lockstep
+                c->variables_capacity = c->variables_capacity ? 2*c->variables_capacity : 8;
+                jit->variables = reallocarray(jit->variables, c->variables_capacity, sizeof(jit->variables[0]));
+                jit->types = reallocarray(jit->types, c->variables_capacity, sizeof(jit->types[0]));
+        }
+        jit->variables[jit->nb_variables] = addr;
+        jit->types[jit->nb_variables] = type;
+        return jit->nb_variables++;
+}
+static size_t assigned_variable(Compiler *const c, const Node* variable) {
+        // assignments go to the current frame
+        const size_t index = variable_index(c, variable);
+        if (index == SIZE_MAX) return SIZE_MAX;
+        const uint32_t depth = c->jit->variables[index].depth;
+        return (depth == 0 || depth == ADDR_GLOBAL) ? index : SIZE_MAX;
+}
+static void add_resume(Compiler *const c, const Node* statement) {
+        JitLoop *const jit = c->jit;
+        GROW(jit->resumes, jit->nb_resumes, c->resumes_capacity);
+        jit->resumes[jit->nb_resumes] = statement;
+        c->resume = jit->nb_resumes++;
+}
+static void add_invariant(Compiler *const c, const Address addr) {
+        JitLoop *const jit = c->jit;
+        GROW(jit->invariants, jit->nb_invariants, c->invariants_capacity);
+        jit->invariants[jit->nb_invariants++] = addr;
+}
+
+// ------------------------------ expressions ----------------------------------
+
+static ObjType compile_expression(Compiler *const c, const Node* node);
+
+static int is_integer(const ObjType type) {
+        return type == TYPE_INT || type == TYPE_BOOL;
+}
+static int is_simple(const Node* node) {
+        // can be loaded in any register, without going through rax
+        return node->operator == OP_LITERAL_INT || node->operator == OP_LITERAL_TRUE
+                || node->operator == OP_LITERAL_FALSE || node->operator == OP_VARIABLE;
+}
+static ObjType compile_simple(Compiler *const c, const Register reg, const Node* node) {
+        switch (node->operator) {
+                case OP_LITERAL_INT:
+                        emit_constant(c, reg, node->operands[0].obj.intval);
+                        return TYPE_INT;
+                case OP_LITERAL_TRUE:
+                        emit_constant(c, reg, 1);
+                        return TYPE_BOOL;
+                case OP_LITERAL_FALSE:
+                        emit_constant(c, reg, 0);
+                        return TYPE_BOOL;
+                default: {
+                        const size_t index = variable_index(c, node);
+                        if (index == SIZE_MAX) return TYPE_ERROR;
+                        emit_load(c, reg, index);
+                        return c->jit->types[index];
+                }
+        }
+}
+static int compile_operands(Compiler *const c, const Node* node) {
+        // the left operand in rax, the right one in rcx
+        if (!is_integer(compile_expression(c, node->operands[0].nd))) return 0;
+        const Node *const right = node->operands[1].nd;
+        if (is_simple(right)) return is_integer(compile_simple(c, RCX, right));
+
+        EMIT(c, 0x50); // push rax
+        if (!is_integer(compile_expression(c, right))) return 0;
+        EMIT(c, 0x48, 0x89, 0xC1); // mov rcx, rax
+        EMIT(c, 0x58); // pop rax
+        return 1;
+}
+static int comparison_jump(const Operator operator) {
+        // the jcc taken when the comparison is false, or 0
+        switch (operator) {
+                case OP_EQ:
+                case OP_EQ_INT_INT:
+                        return JNE;
+                case OP_LT:
+                case OP_LT_INT_INT:
+                        return JGE;
+                case OP_LE:
+                case OP_LE_INT_INT:
+                        return JG;
+                default:
+                        return 0;
+        }
+}
+static uint8_t comparison_setcc(const Operator operator) {
+        switch (operator) {
+                case OP_EQ:
+                case OP_EQ_INT_INT:
+                        return 0x94; // sete
+                case OP_LT:
+                case OP_LT_INT_INT:
+                        return 0x9C; // setl
+                default:
+                        return 0x9E; // setle
+        }
+}
+static ObjType compile_expression(Compiler *const c, const Node* node) {
+        switch (node->operator) {
+                case OP_LITERAL_INT:
+                case OP_LITERAL_TRUE:
+                case OP_LITERAL_FALSE:
+                case OP_VARIABLE:
+                        return compile_simple(c, RAX, node);
+
+                case OP_INVARIANT:
+                        // computed again each time
+                        add_invariant(c, node->operands[1].addr);
+                        return compile_expression(c, node->operands[0].nd);
+
+                case OP_UNARY_PLUS: {
+                        const ObjType type = compile_expression(c, node->operands[0].nd);
+                        return is_integer(type) ? type : TYPE_ERROR;
+                }
+                case OP_UNARY_MINUS:
+                        if (!is_integer(compile_expression(c, node->operands[0].nd))) return TYPE_ERROR;
+                        EMIT(c, 0x48, 0xF7, 0xD8); // neg rax
+                        emit_bailout(c, JO);
+                        return TYPE_INT;
+                case OP_INVERT:
+                        if (!is_integer(compile_expression(c, node->operands[0].nd))) return TYPE_ERROR;
+                        EMIT(c, 0x48, 0x85, 0xC0); // test rax, rax
+                        EMIT(c, 0x0F, 0x94, 0xC0); // sete al
+                        EMIT(c, 0x0F, 0xB6, 0xC0); // movzx eax, al
+                        return TYPE_BOOL;
+
+                case OP_SUM:
+                case OP_SUM_INT_INT:
+                        if (!compile_operands(c, node)) return TYPE_ERROR;
+                        EMIT(c, 0x48, 0x01, 0xC8); // add rax, rcx
+                        emit_bailout(c, JO);
+                        return TYPE_INT;
+                case OP_DIFFERENCE:
+                case OP_DIFFERENCE_INT_INT:
+                        if (!compile_operands(c, node)) return TYPE_ERROR;
+                        EMIT(c, 0x48, 0x29, 0xC8); // sub rax, rcx
+                        emit_bailout(c, JO);
+                        return TYPE_INT;
+                case OP_PRODUCT:
+                case OP_PRODUCT_INT_INT:
+                        if (!compile_operands(c, node)) return TYPE_ERROR;
+                        EMIT(c, 0x48, 0x0F, 0xAF, 0xC1); // imul rax, rcx
+                        emit_bailout(c, JO);
+                        return TYPE_INT;
+
+                case OP_EQ:
+                case OP_EQ_INT_INT:
+                case OP_LT:
+                case OP_LT_INT_INT:
+                case OP_LE:
+                case OP_LE_INT_INT:
+                        if (!compile_operands(c, node)) return TYPE_ERROR;
+                        EMIT(c, 0x48, 0x39, 0xC8); // cmp rax, rcx
+                        EMIT(c, 0x0F, comparison_setcc(node->operator), 0xC0); // setcc al
+                        EMIT(c, 0x0F, 0xB6, 0xC0); // movzx eax, al
+                        return TYPE_BOOL;
+
+                case OP_AND:
+                case OP_OR: {
+                        // the first operand that decides, as is
+                        const ObjType left = compile_expression(c, node->operands[0].nd);
+                        if (!is_integer(left)) return TYPE_ERROR;
+                        EMIT(c, 0x48, 0x85, 0xC0); // test rax, rax
+                        const size_t end = emit_jump(c, (node->operator == OP_AND) ? JE : JNE);
+                        const ObjType right = compile_expression(c, node->operands[1].nd);
+                        patch(c, end, c->len);
+                        return (left == right) ? left : TYPE_ERROR;
+                }
+
+                default:
+                        return TYPE_ERROR;
+        }
+}
+static int compile_condition(Compiler *const c, const Node* node, size_t *const if_false) {
+        // jumps to *if_false (to be patched) when <node> is false
+        const int jump = comparison_jump(node->operator);
+        if (jump) {
+                if (!compile_operands(c, node)) return 0;
+                EMIT(c, 0x48, 0x39, 0xC8); // cmp rax, rcx
+                *if_false = emit_jump(c, jump);
+                return 1;
+        }
+        if (!is_integer(compile_expression(c, node))) return 0;
+        EMIT(c, 0x48, 0x85, 0xC0); // test rax, rax
+        *if_false = emit_jump(c, JE);
+        return 1;
+}
+
+// ------------------------------ statements -----------------------------------
+
+static int compile_statement(Compiler *const c, const Node* node);
+
+static int compile_loop(Compiler *const c, const Node* node) {
+        add_resume(c, node);
+        const size_t top = c->len;
+        size_t end;
+        if (!compile_condition(c, node->operands[0].nd, &end)) return 0;
+        if (!compile_statement(c, node->operands[1].nd)) return 0;
+        emit_jump_to(c, JMP, top);
+        patch(c, end, c->len);
+        return 1;
+}
+static int compile_inplace(Compiler *const c, const Node* node) {
+        // target op= increment, the increment is evaluated first
+        const size_t target = assigned_variable(c, node->operands[0].nd);
+        if (target == SIZE_MAX || c->jit->types[target] != TYPE_INT) return 0;
+        if (!is_integer(compile_expression(c, node->operands[1].nd))) return 0;
+        EMIT(c, 0x48, 0x89, 0xC1); // mov rcx, rax
+        emit_load(c, RAX, target);
+        switch (node->operator) {
+                case OP_IADD:
+                case OP_IADD_INT_INT:
+                        EMIT(c, 0x48, 0x01, 0xC8); // add rax, rcx
+                        break;
+                case OP_ISUB:
+                case OP_ISUB_INT_INT:
+                        EMIT(c, 0x48, 0x29, 0xC8); // sub rax, rcx
+                        break;
+                default:
+                        EMIT(c, 0x48, 0x0F, 0xAF, 0xC1); // imul rax, rcx
+                        break;
+        }
+        emit_bailout(c, JO);
+        emit_store(c, target);
+        return 1;
+}
+static int compile_statement(Compiler *const c, const Node* node) {
+        if (node == NULL) return 0;
+
+        switch (node->operator) {
+                case OP_BLOCK:
+                        for (uintptr_t i=1; i<=node->operands[0].len; i++) {
+                                if (!compile_statement(c, node->operands[i].nd)) return 0;
+                        }
+                        return 1;
+                case OP_IFELSE: {
+                        add_resume(c, node);
+                        size_t if_false;
+                        if (!compile_condition(c, node->operands[0].nd, &if_false)) return 0;
+                        if (!compile_statement(c, node->operands[1].nd)) return 0;
+                        if (node->operands[2].nd == NULL) {
+                                patch(c, if_false, c->len);
+                                return 1;
+                        }
+                        const size_t end = emit_jump(c, JMP);
+                        patch(c, if_false, c->len);
+                        if (!compile_statement(c, node->operands[2].nd)) return 0;
+                        patch(c, end, c->len);
+                        return 1;
+                }
+                case OP_WHILE:
+                        return compile_loop(c, node);
+                case OP_NOP:
+                case OP_FORGET: // the hoisted expressions are computed again anyway
+                        return 1;
+
+                case OP_AFFECT: {
+                        add_resume(c, node);
+                        const size_t target = assigned_variable(c, node->operands[0].nd);
+                        if (target == SIZE_MAX) return 0;
+                        if (compile_expression(c, node->operands[1].nd) != c->jit->types[target]) return 0;
+                        emit_store(c, target);
+                        return 1;
+                }
+                case OP_IADD:
+                case OP_IADD_INT_INT:
+                case OP_ISUB:
+                case OP_ISUB_INT_INT:
+                case OP_IMUL:
+                        add_resume(c, node);
+                        return compile_inplace(c, node);
+
+                default:
+                        // an expression, for nothing
+                        add_resume(c, node);
+                        return compile_expression(c, node) != TYPE_ERROR;
+        }
+}
+
+// ------------------------------ entry points ---------------------------------
+
+static void free_loop(JitLoop* jit) {
+        if (jit->code != NULL) munmap(jit->code, jit->code_size);
+        free(jit->variables);
+        free(jit->types);
+        free(jit->resumes);
+        free(jit->invariants);
+        free(jit);
+}
+static int install(Compiler *const c) {
+        // W^X: written, then made executable
+        const size_t page = sysconf(_SC_PAGESIZE);
+        const size_t size = (c->len + page-1) / page * page;
+        void *const code = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        if (code == MAP_FAILED) return 0;
+        memcpy(code, c->code, c->len);
+        if (mprotect(code, size, PROT_READ|PROT_EXEC)) {
+                munmap(code, size);
+                return 0;
+        }
+        c->jit->code = code;
+        c->jit->code_size = size;
+        return 1;
+}
+
+JitLoop* jit_compile(const Node* loop, Namespace *const ns) {
+        if (!current_vm->jit_enabled) return &declined;
+
+        Compiler c = {.jit=calloc(1, sizeof(JitLoop)), .ns=ns, .ok=1};
+
+        // the epilogue comes first, so that every exit jumps backwards to it
+        const size_t exit = c.len;
+        EMIT(&c, 0x48, 0x8B, 0x5D, 0xF8); // mov rbx, [rbp-8]
+        EMIT(&c, 0xC9); // leave
+        EMIT(&c, 0xC3); // ret
+
+        const size_t entry = c.len;
+        EMIT(&c, 0xF3, 0x0F, 0x1E, 0xFA); // endbr64
+        EMIT(&c, 0x55); // push rbp
+        EMIT(&c, 0x48, 0x89, 0xE5); // mov rbp, rsp
+        EMIT(&c, 0x53); // push rbx
+        EMIT(&c, 0x48, 0x89, 0xFB); // mov rbx, rdi
+
+        c.ok = compile_loop(&c, loop);
+        emit_constant(&c, RAX, -1);
+        emit_jump_to(&c, JMP, exit);
+
+        for (size_t i=0; i<c.nb_bailouts; i++) {
+                patch(&c, c.bailouts[i].patch, c.len);
+                EMIT(&c, 0xB8); // mov eax, imm32
+                emit_u32(&c, c.bailouts[i].resume);
+                emit_jump_to(&c, JMP, exit);
+        }
+
+        if (c.ok) c.ok = install(&c);
+        free(c.code);
+        free(c.bailouts);
+        if (!c.ok) {
+                LOG("The loop at line %u can't be compiled", source_position(loop->token.offset).line);
+                free_loop(c.jit);
+                return &declined;
+        }
+
+        LOG("Compiled the loop at line %u, %lu bytes", source_position(loop->token.offset).line, c.len);
+        c.jit->entry = (JitEntry) ((uint8_t*) c.jit->code + entry);
+        c.jit->next = current_vm->compiled_loops;
+        current_vm->compiled_loops = c.jit;
+        return c.jit;
+}
+
+void jit_release(void) {
+        JitLoop** loops = &(current_vm->compiled_loops);
+        while (*loops != NULL) {
+                JitLoop *const next = (*loops)->next;
+                free_loop(*loops);
+                *loops = next;
+        }
+}
+
+#undef GROW
+#undef EMIT
+#undef JO
+#undef JNE
+#undef JE
+#undef JG
+#undef JGE
+#undef JMP
+
+#else
+
+JitLoop* jit_compile(const Node* loop, Namespace *const ns) {
+        return &declined;
+}
+void jit_release(void) {}
+
+#endif
+
+const Node* jit_run(JitLoop *const jit, const Node* loop, Namespace *const ns) {
+        if (jit->disabled) return loop;
+
+        // the slots don't move while the code runs: it neither calls nor assigns new variables
+        Object** slots = alloca(jit->nb_variables * sizeof(slots[0]));
+        for (size_t i=0; i<jit->nb_variables; i++) {
+                slots[i] = ns_get_value(ns, jit->variables[i]);
+                if (slots[i] == NULL || !has_type(*slots[i], jit->types[i])) return loop;
+        }
+
+        const intptr_t resume = jit->entry(slots);
+        if (resume < 0) return NULL;
+
+        LOG("Bailing out of the loop at line %u", source_position(loop->token.offset).line);
+        jit->disabled = 1;
+        for (size_t i=0; i<jit->nb_invariants; i++) ns_set_value(ns, jit->invariants[i], ERROR);
+        return jit->resumes[resume];
+}
@@ -3,63 +3,88 @@
 #include <stddef.h>
 #include <string.h>
 
-#include "interpreter/pipeline.h"
-#include "lexer.h"
-#include "interpreter/parser.h"
+#include "interpreter/vm.h"
 #include "interpreter/interpreter.h"
-#include "interpreter/builtins.h"
-#include "keywords.h"
+#include "interpreter/gc.h"
+#include "interpreter/profiler.h"
 
-static const Keyword keywords[] = {
-        {"true", TOKEN_TRUE},
-        {"false", TOKEN_FALSE},
-        {"none", TOKEN_NONE},
-        {"if", TOKEN_IF},
-        {"else", TOKEN_ELSE},
-        {"while", TOKEN_WHILE},
-        {"function", TOKEN_FUNC},
-        {"return", TOKEN_RETURN},
-
-        {NULL, 0}
-};
+#define OUTPUT_BUFFER (1<<16) // bytes
 
+int main(int argc, char* argv[]) {
+        static const char usage[] = "Usage : %s [--gc-stats] [--no-cache] [--profile] [--no-jit] [file]\n";
 
-static inline void declare_variable(pipeline_state *const pipeline, const char* key, Object value) {
-        ns_set_value(
-                &(pipeline->interpinfo.ns),
-                internalize(&(pipeline->interpinfo.prsinfo.lxinfo.record), strdup(key), strlen(key)),
-                value
-        );
-}
+        int show_gc_stats = 0;
+        int use_cache = 1;
+        int profile = 0;
+        int jit = 1;
+        int iarg = 1;
+        for (; iarg < argc && !strncmp(argv[iarg], "--", 2); iarg++) {
+                if (!strcmp(argv[iarg], "--gc-stats")) show_gc_stats = 1;
+                else if (!strcmp(argv[iarg], "--no-cache")) use_cache = 0;
+                else if (!strcmp(argv[iarg], "--profile")) profile = 1;
+                else if (!strcmp(argv[iarg], "--no-jit")) jit = 0;
+                else {
+                        printf("Unknown option %s.\n", argv[iarg]);
+                        printf(usage, argv[0]);
+                        return EXIT_FAILURE;
+                }
+        }
 
-int main(int argc, char* argv[]) {
         FILE* source_code;
-        switch (argc) {
-                case 1:
+        switch (argc - iarg) {
+                case 0:
                         source_code = stdin; break;
-                case 2:
-                        source_code = fopen(argv[1], "r"); break;
+                case 1:
+                        source_code = fopen(argv[iarg], "r"); break;
                 default:
-                        printf("Invalid number of arguments.\nUsage : %s [file]", argv[0]);
+                        printf("Invalid number of arguments.\n");
+                        printf(usage, argv[0]);
                         return EXIT_FAILURE;
         }
-        pipeline_state state;
-        mk_pipeline(&state, source_code, keywords);
+        // a script's output is block-buffered, even to a terminal; input() and errors flush it
+        // the REPL keeps the default, so that results show up as statements are typed
+        if (source_code != stdin) setvbuf(stdout, NULL, _IOFBF, OUTPUT_BUFFER);
 
-        declare_variable(&state, "print", (Object){.type=TYPE_NATIVEF, .natfunval=&print_value});
-        declare_variable(&state, "clock", (Object){.type=TYPE_NATIVEF, .natfunval=&native_clock});
+        // no input in REPL, because reading tokens and input from the same source cases havroc
+        mylang_vm *const vm = mk_vm(NULL, source_code, source_code != stdin);
+        enter_vm(vm);
+        vm->jit_enabled = jit;
 
-        declare_variable(&state, "str", (Object){.type=TYPE_NATIVEF, .natfunval=&tostring});
-        declare_variable(&state, "bool", (Object){.type=TYPE_NATIVEF, .natfunval=&tobool});
-        declare_variable(&state, "int", (Object){.type=TYPE_NATIVEF, .natfunval=&toint});
-        declare_variable(&state, "float", (Object){.type=TYPE_NATIVEF, .natfunval=&tofloat});
+        if (profile) {
+                start_profiler();
+                vm->jit_enabled = 0; // compiled loops would escape the profiler
+        }
 
-        // no input in REPL, because reading tokens and input from the same source cases havroc
-        if (argc == 2) declare_variable(&state, "input", (Object){.type=TYPE_NATIVEF, .natfunval=&input});
+        interpreter_info *const interpinfo = &(vm->pipeline.interpinfo);
+        if (source_code == stdin) while (interpretStatement(interpinfo) == OK_OK);
+        else {
+                // the precompiled program lives next to the script
+                char* cache_path = NULL;
+                if (use_cache) {
+                        cache_path = malloc(strlen(argv[iarg]) + sizeof(".cache"));
+                        strcat(strcpy(cache_path, argv[iarg]), ".cache");
+                }
+                interpretProgram(interpinfo, cache_path);
+                free(cache_path);
+        }
 
-        while (interpretStatement(&(state.interpinfo)) == OK_OK);
+        if (profile) {
+                // folded stacks go next to the script, the summary to stderr
+                const char *const script = (source_code == stdin) ? "stdin" : argv[iarg];
+                char *const folded_path = malloc(strlen(script) + sizeof(".folded"));
+                strcat(strcpy(folded_path, script), ".folded");
+                FILE *const folded = fopen(folded_path, "w");
+                if (folded == NULL) fprintf(stderr, "Can't write the profile to %s.\n", folded_path);
+                fflush(stdout);
+                stop_profiler(folded, stderr);
+                if (folded != NULL) fclose(folded);
+                free(folded_path);
+        }
+        if (show_gc_stats) print_gc_stats(stderr);
 
-        del_pipeline(&state);
+        del_vm(vm);
 
         return EXIT_SUCCESS;
 }
+
+#undef OUTPUT_BUFFER
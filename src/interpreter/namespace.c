@@ -4,12 +4,12 @@
 
 #include "interpreter/namespace.h"
 
-static void growNS(Namespace* ns) {
-        const size_t new_size = ns->len * 2;
+static void growNS(Namespace* ns, const size_t min_size) {
+        size_t new_size = ns->len * 2;
+        while (new_size < min_size) new_size *= 2;
 
-        LOG("Namespace grows from %lu to %lu entries, because it contains %lu variables", ns->len, new_size, ns->nb_entries);
+        LOG("Namespace grows from %lu to %lu slots", ns->len, new_size);
 
-        ns->keys = reallocarray(ns->keys, new_size, sizeof(ns->keys[0]));
         ns->values = reallocarray(ns->values, new_size, sizeof(ns->values[0]));
 
         ns->len = new_size;
@@ -17,72 +17,123 @@ static void growNS(Namespace* ns) {
 
 Namespace allocateNamespace(void) {
         static const size_t ns_start_len = 16;
+        static const size_t frames_start_len = 8;
+        static const size_t stack_start_len = 16;
 
         Namespace new;
 
-        new.keys = calloc(sizeof(new.keys[0]), ns_start_len);
         new.values = calloc(sizeof(new.values[0]), ns_start_len);
-        new.nb_entries = 0;
         new.len = ns_start_len;
+        new.frames = calloc(sizeof(new.frames[0]), frames_start_len);
+        new.frames_len = frames_start_len;
 
-        pushNamespace(&new);
+        // the global frame
+        new.frames[0] = (Frame) {.base=0, .len=0, .link=SIZE_MAX, .serial=0, .level=0, .captured=0};
+        new.nb_frames = 1;
+        new.serials = 0;
+
+        new.stack = calloc(sizeof(new.stack[0]), stack_start_len);
+        new.stack_len = stack_start_len;
+        new.stack_top = 0;
+
+        new.statement = NULL;
+        new.staging = OBJ_NONE;
 
         return new;
 }
 void freeNamespace(Namespace* ns) {
-        free(ns->keys);
         free(ns->values);
+        free(ns->frames);
+        free(ns->stack);
 }
 
-void ns_set_value(Namespace *const ns, char *const key, Object value) {
-        // tunable according to your cache size
-        static const unsigned lookupbuffer = 64/(2*sizeof(ns->keys[0]));
+void ns_set_value(Namespace *const ns, const Address addr, Object value) {
+        Frame *const frame = (addr.depth == ADDR_GLOBAL) ? &(ns->frames[0]) : &(ns->frames[ns->nb_frames-1]);
 
-        for (unsigned i=0; i<lookupbuffer; i++) {
-                if (ns->keys[ns->nb_entries-1-i] == NULL) break;
-                if (ns->keys[ns->nb_entries-1-i] == key) {
-                        ns->values[ns->nb_entries-1-i] = value;
-                        return;
-                }
+        if (addr.slot >= frame->len) {
+                // the frame is on top of the stack, we can extend it
+                const size_t new_top = frame->base + addr.slot + 1;
+                if (ns->len < new_top) growNS(ns, new_top);
+                for (size_t i=frame->base+frame->len; i<new_top; i++) ns->values[i] = ERROR;
+                frame->len = addr.slot + 1;
         }
 
-        if (ns->len <= ns->nb_entries) growNS(ns);
-
-        ns->keys[ns->nb_entries] = key;
-        ns->values[ns->nb_entries] = value;
-
-        ns->nb_entries++;
+        ns->values[frame->base + addr.slot] = value;
 }
 
-Object* ns_get_value(Namespace *const ns, const char* key) {
-        size_t entry = ns->nb_entries;
+Object* ns_get_value(Namespace *const ns, const Address addr) {
+        size_t iframe;
+        if (addr.depth == ADDR_GLOBAL) iframe = 0;
+        else {
+                iframe = ns->nb_frames-1;
+                for (uint32_t i=0; i<addr.depth; i++) {
+                        iframe = ns->frames[iframe].link;
+                        if (iframe == SIZE_MAX) return NULL;
+                }
+        }
 
-        do {
-                entry--;
-                if (ns->keys[entry] == key) return &(ns->values[entry]);
-        } while (entry != 0);
+        const Frame frame = ns->frames[iframe];
+        if (addr.slot >= frame.len) return NULL;
 
-        return NULL;
+        Object *const value = &(ns->values[frame.base + addr.slot]);
+        if (OBJ_TYPE(*value) == TYPE_ERROR) return NULL;
+        else return value;
 }
 
-Object* ns_get_rw_value(Namespace *const ns, const char* key) {
-        size_t entry = ns->nb_entries;
+static size_t static_link(const Namespace* ns, const ObjFunction* function) {
+        // the environment of the function, unless its call is over
+        const Environment env = function->env;
+        if (env.frame >= ns->nb_frames) return SIZE_MAX;
+        const Frame *const frame = &(ns->frames[env.frame]);
+        if (frame->serial != env.serial || frame->level != function->level-1) return SIZE_MAX;
+        return env.frame;
+}
 
-        do {
-                entry--;
-                if (ns->keys[entry] == NULL) break;
-                if (ns->keys[entry] == key) return &(ns->values[entry]);
-        } while (entry != 0);
+static void fill_frame(Namespace *const ns, Frame *const frame, const size_t frame_size, const Object* args, const size_t argc) {
+        const size_t new_top = frame->base + frame_size;
+        if (ns->len < new_top) growNS(ns, new_top);
 
-        return NULL;
+        Object *const slots = &(ns->values[frame->base]);
+        memcpy(slots, args, argc*sizeof(slots[0]));
+        for (size_t i=argc; i<frame_size; i++) slots[i] = ERROR;
+        frame->len = frame_size;
 }
 
-size_t pushNamespace(Namespace *const ns) {
-        if (ns->len <= ns->nb_entries) growNS(ns);
-        ns->nb_entries++;
-        ns->keys[ns->nb_entries] = NULL;
-        return ns->nb_entries-1;
+size_t pushNamespace(Namespace *const ns, const ObjFunction* function, const Object* args, const size_t argc) {
+        if (ns->frames_len <= ns->nb_frames) {
+                ns->frames_len *= 2;
+                ns->frames = reallocarray(ns->frames, ns->frames_len, sizeof(ns->frames[0]));
+        }
+
+        const Frame top = ns->frames[ns->nb_frames-1];
+        Frame *const frame = &(ns->frames[ns->nb_frames]);
+        *frame = (Frame) {.base=top.base+top.len, .len=0, .link=static_link(ns, function), .serial=++ns->serials, .level=function->level, .captured=0};
+        fill_frame(ns, frame, function->frame_size, args, argc);
+
+        return ns->nb_frames++;
 }
 void popNamespace(Namespace *const ns, size_t restore) {
-        ns->nb_entries = restore;
+        ns->nb_frames = restore;
+}
+void reuseNamespace(Namespace *const ns, const ObjFunction* function, const Object* args, const size_t argc) {
+        Frame *const top = &(ns->frames[ns->nb_frames-1]);
+        // a new call: it gets a new serial, though no function was created by the previous one
+        top->link = static_link(ns, function);
+        top->serial = ++ns->serials;
+        top->level = function->level;
+        fill_frame(ns, top, function->frame_size, args, argc);
+}
+Environment ns_environment(Namespace *const ns) {
+        Frame *const top = &(ns->frames[ns->nb_frames-1]);
+        top->captured = 1;
+        return (Environment) {.frame=ns->nb_frames-1, .serial=top->serial};
+}
+
+size_t ns_push(Namespace *const ns, Object value) {
+        if (ns->stack_len <= ns->stack_top) {
+                ns->stack_len *= 2;
+                ns->stack = reallocarray(ns->stack, ns->stack_len, sizeof(ns->stack[0]));
+        }
+        ns->stack[ns->stack_top] = value;
+        return ns->stack_top++;
 }
@@ -0,0 +1,453 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "interpreter/numconv.h"
+
+#define IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+#define MAX_SIGNIFICANT 19 // decimal digits that always fit in an uint64_t
+#define MAX_EXACT_POW10 22 // 10^22 is the largest power of 10 that a double holds exactly
+#define MAX_EXACT_INT (UINT64_C(1) << 53)
+#define MAX_EXPONENT 100000 // any exponent past this gives an infinity or zero
+#define SLOW_PATH_BUFFER 64
+
+// ------------------------------ ints -----------------------------------------
+
+static const char digit_pairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+char* format_int(const intmax_t value, char *const end) {
+        // two digits at a time, from the least significant ones
+        uintmax_t magnitude = (value < 0) ? -(uintmax_t) value : (uintmax_t) value;
+        char* start = end;
+        while (magnitude >= 100) {
+                const size_t pair = (magnitude % 100) * 2;
+                magnitude /= 100;
+                *--start = digit_pairs[pair+1];
+                *--start = digit_pairs[pair];
+        }
+        if (magnitude >= 10) {
+                *--start = digit_pairs[magnitude*2+1];
+                *--start = digit_pairs[magnitude*2];
+        }
+        else *--start = '0' + magnitude;
+        if (value < 0) *--start = '-';
+        return start;
+}
+
+ParseResult parse_int(const char* text, const size_t len, intmax_t *const value) {
+        size_t i = 0;
+        int negative = 0;
+        if (len && (text[0] == '-' || text[0] == '+')) {
+                negative = (text[0] == '-');
+                i++;
+        }
+        if (i == len) return PARSE_INVALID;
+
+        const uintmax_t limit = negative ? (uintmax_t) INTMAX_MAX + 1 : (uintmax_t) INTMAX_MAX;
+        uintmax_t magnitude = 0;
+        int overflow = 0;
+        for (; i<len; i++) {
+                if (!IS_DIGIT(text[i])) return PARSE_INVALID;
+                const unsigned digit = text[i] - '0';
+                if (magnitude > (limit - digit) / 10) overflow = 1;
+                else magnitude = magnitude*10 + digit;
+        }
+        if (overflow) return PARSE_OVERFLOW;
+
+        *value = negative ? (intmax_t) (0 - magnitude) : (intmax_t) magnitude;
+        return PARSE_OK;
+}
+
+// ------------------------------ floats, out ----------------------------------
+
+/*
+Grisu2, after Florian Loitsch's "Printing Floating-Point Numbers Quickly and
+Accurately with Integers". The digits always read back as the same double,
+but they are not always the shortest such digits (1e23 gives
+9999999999999999e7): shortest() then drops the extra ones.
+*/
+
+typedef struct DiyFp {
+        // f.2^e, with a 64-bit significand and no hidden bit
+        uint64_t f;
+        int e;
+} DiyFp;
+
+#define DP_SIGNIFICAND_BITS 52
+#define DP_HIDDEN_BIT (UINT64_C(1) << DP_SIGNIFICAND_BITS)
+#define DP_EXPONENT_BIAS (0x3FF + DP_SIGNIFICAND_BITS)
+
+static const DiyFp cached_powers[] = {
+        // 10^-348, 10^-340, ..., 10^340, normalized
+        {UINT64_C(0xfa8fd5a0081c0288), -1220}, {UINT64_C(0xbaaee17fa23ebf76), -1193}, {UINT64_C(0x8b16fb203055ac76), -1166},
+        {UINT64_C(0xcf42894a5dce35ea), -1140}, {UINT64_C(0x9a6bb0aa55653b2d), -1113}, {UINT64_C(0xe61acf033d1a45df), -1087},
+        {UINT64_C(0xab70fe17c79ac6ca), -1060}, {UINT64_C(0xff77b1fcbebcdc4f), -1034}, {UINT64_C(0xbe5691ef416bd60c), -1007},
+        {UINT64_C(0x8dd01fad907ffc3c), -980}, {UINT64_C(0xd3515c2831559a83), -954}, {UINT64_C(0x9d71ac8fada6c9b5), -927},
+        {UINT64_C(0xea9c227723ee8bcb), -901}, {UINT64_C(0xaecc49914078536d), -874}, {UINT64_C(0x823c12795db6ce57), -847},
+        {UINT64_C(0xc21094364dfb5637), -821}, {UINT64_C(0x9096ea6f3848984f), -794}, {UINT64_C(0xd77485cb25823ac7), -768},
+        {UINT64_C(0xa086cfcd97bf97f4), -741}, {UINT64_C(0xef340a98172aace5), -715}, {UINT64_C(0xb23867fb2a35b28e), -688},
+        {UINT64_C(0x84c8d4dfd2c63f3b), -661}, {UINT64_C(0xc5dd44271ad3cdba), -635}, {UINT64_C(0x936b9fcebb25c996), -608},
+        {UINT64_C(0xdbac6c247d62a584), -582}, {UINT64_C(0xa3ab66580d5fdaf6), -555}, {UINT64_C(0xf3e2f893dec3f126), -529},
+        {UINT64_C(0xb5b5ada8aaff80b8), -502}, {UINT64_C(0x87625f056c7c4a8b), -475}, {UINT64_C(0xc9bcff6034c13053), -449},
+        {UINT64_C(0x964e858c91ba2655), -422}, {UINT64_C(0xdff9772470297ebd), -396}, {UINT64_C(0xa6dfbd9fb8e5b88f), -369},
+        {UINT64_C(0xf8a95fcf88747d94), -343}, {UINT64_C(0xb94470938fa89bcf), -316}, {UINT64_C(0x8a08f0f8bf0f156b), -289},
+        {UINT64_C(0xcdb02555653131b6), -263}, {UINT64_C(0x993fe2c6d07b7fac), -236}, {UINT64_C(0xe45c10c42a2b3b06), -210},
+        {UINT64_C(0xaa242499697392d3), -183}, {UINT64_C(0xfd87b5f28300ca0e), -157}, {UINT64_C(0xbce5086492111aeb), -130},
+        {UINT64_C(0x8cbccc096f5088cc), -103}, {UINT64_C(0xd1b71758e219652c), -77}, {UINT64_C(0x9c40000000000000), -50},
+        {UINT64_C(0xe8d4a51000000000), -24}, {UINT64_C(0xad78ebc5ac620000), 3}, {UINT64_C(0x813f3978f8940984), 30},
+        {UINT64_C(0xc097ce7bc90715b3), 56}, {UINT64_C(0x8f7e32ce7bea5c70), 83}, {UINT64_C(0xd5d238a4abe98068), 109},
+        {UINT64_C(0x9f4f2726179a2245), 136}, {UINT64_C(0xed63a231d4c4fb27), 162}, {UINT64_C(0xb0de65388cc8ada8), 189},
+        {UINT64_C(0x83c7088e1aab65db), 216}, {UINT64_C(0xc45d1df942711d9a), 242}, {UINT64_C(0x924d692ca61be758), 269},
+        {UINT64_C(0xda01ee641a708dea), 295}, {UINT64_C(0xa26da3999aef774a), 322}, {UINT64_C(0xf209787bb47d6b85), 348},
+        {UINT64_C(0xb454e4a179dd1877), 375}, {UINT64_C(0x865b86925b9bc5c2), 402}, {UINT64_C(0xc83553c5c8965d3d), 428},
+        {UINT64_C(0x952ab45cfa97a0b3), 455}, {UINT64_C(0xde469fbd99a05fe3), 481}, {UINT64_C(0xa59bc234db398c25), 508},
+        {UINT64_C(0xf6c69a72a3989f5c), 534}, {UINT64_C(0xb7dcbf5354e9bece), 561}, {UINT64_C(0x88fcf317f22241e2), 588},
+        {UINT64_C(0xcc20ce9bd35c78a5), 614}, {UINT64_C(0x98165af37b2153df), 641}, {UINT64_C(0xe2a0b5dc971f303a), 667},
+        {UINT64_C(0xa8d9d1535ce3b396), 694}, {UINT64_C(0xfb9b7cd9a4a7443c), 720}, {UINT64_C(0xbb764c4ca7a44410), 747},
+        {UINT64_C(0x8bab8eefb6409c1a), 774}, {UINT64_C(0xd01fef10a657842c), 800}, {UINT64_C(0x9b10a4e5e9913129), 827},
+        {UINT64_C(0xe7109bfba19c0c9d), 853}, {UINT64_C(0xac2820d9623bf429), 880}, {UINT64_C(0x80444b5e7aa7cf85), 907},
+        {UINT64_C(0xbf21e44003acdd2d), 933}, {UINT64_C(0x8e679c2f5e44ff8f), 960}, {UINT64_C(0xd433179d9c8cb841), 986},
+        {UINT64_C(0x9e19db92b4e31ba9), 1013}, {UINT64_C(0xeb96bf6ebadf77d9), 1039}, {UINT64_C(0xaf87023b9bf0ee6b), 1066},
+};
+static const uint64_t pow10_64[] = {
+        UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000), UINT64_C(10000),
+        UINT64_C(100000), UINT64_C(1000000), UINT64_C(10000000), UINT64_C(100000000),
+        UINT64_C(1000000000), UINT64_C(10000000000), UINT64_C(100000000000),
+        UINT64_C(1000000000000), UINT64_C(10000000000000), UINT64_C(100000000000000),
+        UINT64_C(1000000000000000), UINT64_C(10000000000000000), UINT64_C(100000000000000000),
+        UINT64_C(1000000000000000000), UINT64_C(10000000000000000000)
+};
+
+static DiyFp diy_of_double(const double value) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        const int biased = (bits >> DP_SIGNIFICAND_BITS) & 0x7FF;
+        const uint64_t significand = bits & (DP_HIDDEN_BIT - 1);
+        if (biased) return (DiyFp) {.f=significand + DP_HIDDEN_BIT, .e=biased - DP_EXPONENT_BIAS};
+        return (DiyFp) {.f=significand, .e=1 - DP_EXPONENT_BIAS}; // subnormal
+}
+static DiyFp diy_normalize(const DiyFp x) {
+        const int shift = __builtin_clzll(x.f);
+        return (DiyFp) {.f=x.f << shift, .e=x.e - shift};
+}
+static DiyFp diy_multiply(const DiyFp a, const DiyFp b) {
+        const unsigned __int128 product = (unsigned __int128) a.f * b.f;
+        uint64_t high = product >> 64;
+        if ((uint64_t) product >> 63) high++; // rounded
+        return (DiyFp) {.f=high, .e=a.e + b.e + 64};
+}
+static void boundaries(const DiyFp v, DiyFp *const minus, DiyFp *const plus) {
+        // halfway to the neighbouring doubles, both with the exponent of the normalized upper one
+        *plus = diy_normalize((DiyFp) {.f=(v.f << 1) + 1, .e=v.e - 1});
+        if (v.f == DP_HIDDEN_BIT) *minus = (DiyFp) {.f=(v.f << 2) - 1, .e=v.e - 2}; // the lower gap is narrower
+        else *minus = (DiyFp) {.f=(v.f << 1) - 1, .e=v.e - 1};
+        minus->f <<= minus->e - plus->e;
+        minus->e = plus->e;
+}
+static DiyFp cached_power(const int e, int *const K) {
+        // a power of ten c = 10^-K such that c.2^e is in [2^-60, 2^-32[
+        const double dk = (-61 - e) * 0.30102999566398114 + 347; // log10(2)
+        int k = (int) dk;
+        if (dk - k > 0.0) k++;
+        const unsigned index = (unsigned) ((k >> 3) + 1);
+        *K = -(-348 + (int) (index << 3));
+        return cached_powers[index];
+}
+static int count_digits(const uint32_t n) {
+        for (int i=1; i<10; i++) if (n < pow10_64[i]) return i;
+        return 10;
+}
+static void round_weed(char *const buffer, const int len, const uint64_t delta, uint64_t rest, const uint64_t ten_kappa, const uint64_t wp_w) {
+        // lowers the last digit while that brings the digits closer to the exact value
+        while (rest < wp_w && delta - rest >= ten_kappa
+                && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+                buffer[len-1]--;
+                rest += ten_kappa;
+        }
+}
+static int generate_digits(const DiyFp w, const DiyFp mp, uint64_t delta, char *const buffer, int *const K) {
+        // returns the number of digits
+        const int shift = -mp.e;
+        const uint64_t one = UINT64_C(1) << shift;
+        const uint64_t wp_w = mp.f - w.f;
+        uint32_t p1 = mp.f >> shift; // integral part
+        uint64_t p2 = mp.f & (one - 1); // fractional part
+        int kappa = count_digits(p1);
+        int len = 0;
+
+        while (kappa > 0) {
+                const uint32_t digit = p1 / (uint32_t) pow10_64[kappa-1];
+                p1 %= (uint32_t) pow10_64[kappa-1];
+                if (digit || len) buffer[len++] = '0' + digit;
+                kappa--;
+                const uint64_t rest = ((uint64_t) p1 << shift) + p2;
+                if (rest <= delta) {
+                        *K += kappa;
+                        round_weed(buffer, len, delta, rest, pow10_64[kappa] << shift, wp_w);
+                        return len;
+                }
+        }
+        for (;;) {
+                p2 *= 10;
+                delta *= 10;
+                const char digit = p2 >> shift;
+                if (digit || len) buffer[len++] = '0' + digit;
+                p2 &= one - 1;
+                kappa--;
+                if (p2 < delta) {
+                        *K += kappa;
+                        // wp_w is below the initial delta, so this doesn't overflow either
+                        round_weed(buffer, len, delta, p2, one, (-kappa < 20) ? wp_w * pow10_64[-kappa] : 0);
+                        return len;
+                }
+        }
+}
+static int grisu2(const double value, char *const buffer, int *const K) {
+        // value = buffer.10^K; value is finite and positive
+        const DiyFp v = diy_of_double(value);
+        DiyFp minus, plus;
+        boundaries(v, &minus, &plus);
+        const DiyFp c = cached_power(plus.e, K);
+        const DiyFp w = diy_multiply(diy_normalize(v), c);
+        DiyFp wp = diy_multiply(plus, c);
+        DiyFp wm = diy_multiply(minus, c);
+        wm.f++; // the products are off by at most 1 ulp: stay on the safe side
+        wp.f--;
+        return generate_digits(w, wp, wp.f - wm.f, buffer, K);
+}
+
+static int reads_back(const char* digits, const int len, const int K, const double value) {
+        char text[48];
+        memcpy(text, digits, len);
+        text[len] = 'e';
+        char *const end = text + sizeof(text);
+        const char *const exponent = format_int(K, end);
+        memmove(text+len+1, exponent, end - exponent);
+        double read;
+        return parse_float(text, len+1 + (end - exponent), &read) == PARSE_OK && read == value;
+}
+static int shortest(const double value, char *const digits, int len, int *const K) {
+        // the (len-1)-digit numbers around digits.10^K are the nearest ones to value:
+        // if neither reads back as value, no shorter digits do either
+        while (len > 1) {
+                char up[24];
+                memcpy(up, digits, len-1);
+                int up_len = len-1, up_K = *K+1;
+                int i = up_len-1;
+                while (i >= 0 && up[i] == '9') up[i--] = '0';
+                if (i >= 0) up[i]++;
+                else {
+                        up[0] = '1';
+                        up_len = 1;
+                        up_K += len-1;
+                }
+                const int down_ok = reads_back(digits, len-1, *K+1, value);
+                const int up_ok = reads_back(up, up_len, up_K, value);
+                if (!down_ok && !up_ok) break;
+                if (up_ok && (!down_ok || digits[len-1] > '5')) {
+                        memcpy(digits, up, up_len);
+                        len = up_len;
+                        *K = up_K;
+                } else {
+                        len--;
+                        (*K)++;
+                }
+                while (len > 1 && digits[len-1] == '0') {
+                        len--;
+                        (*K)++;
+                }
+        }
+        return len;
+}
+
+size_t format_float(const double value, char buffer[FLOAT_CHARS]) {
+        if (value != value) {
+                memcpy(buffer, "nan", 3);
+                return 3;
+        }
+        size_t pos = 0;
+        if (signbit(value)) buffer[pos++] = '-';
+        const double magnitude = signbit(value) ? -value : value;
+        if (magnitude == INFINITY) {
+                memcpy(buffer+pos, "inf", 3);
+                return pos+3;
+        }
+        if (magnitude == 0) {
+                memcpy(buffer+pos, "0.0", 3);
+                return pos+3;
+        }
+
+        char digits[24];
+        int K;
+        const int len = shortest(magnitude, digits, grisu2(magnitude, digits, &K), &K);
+        const int point = len + K; // digits before the decimal point
+
+        if (point > -4 && point <= 16) {
+                if (point <= 0) {
+                        // 0.000ddd
+                        memcpy(buffer+pos, "0.", 2);
+                        pos += 2;
+                        memset(buffer+pos, '0', -point);
+                        pos += -point;
+                        memcpy(buffer+pos, digits, len);
+                        pos += len;
+                } else if (point < len) {
+                        // ddd.ddd
+                        memcpy(buffer+pos, digits, point);
+                        pos += point;
+                        buffer[pos++] = '.';
+                        memcpy(buffer+pos, digits+point, len-point);
+                        pos += len-point;
+                } else {
+                        // ddd000.0
+                        memcpy(buffer+pos, digits, len);
+                        pos += len;
+                        memset(buffer+pos, '0', point-len);
+                        pos += point-len;
+                        memcpy(buffer+pos, ".0", 2);
+                        pos += 2;
+                }
+                return pos;
+        }
+
+        // d.ddde+XX
+        buffer[pos++] = digits[0];
+        if (len > 1) {
+                buffer[pos++] = '.';
+                memcpy(buffer+pos, digits+1, len-1);
+                pos += len-1;
+        }
+        int exponent = point - 1;
+        buffer[pos++] = 'e';
+        buffer[pos++] = (exponent < 0) ? '-' : '+';
+        if (exponent < 0) exponent = -exponent;
+        if (exponent >= 100) buffer[pos++] = '0' + exponent/100;
+        buffer[pos++] = '0' + exponent/10%10;
+        buffer[pos++] = '0' + exponent%10;
+        return pos;
+}
+
+// ------------------------------ floats, in -----------------------------------
+
+static const double exact_pow10[MAX_EXACT_POW10+1] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static int is_word(const char* text, const size_t len, const char* word) {
+        // case-insensitive, for lowercase ASCII words
+        if (strlen(word) != len) return 0;
+        for (size_t i=0; i<len; i++) if ((text[i] | 0x20) != word[i]) return 0;
+        return 1;
+}
+static double slow_path(const char* text, const size_t len, const long exponent) {
+        // only digits and an exponent are left for strtod, so that the locale's decimal point doesn't matter
+        char small[SLOW_PATH_BUFFER];
+        char *const buffer = (len+24 <= SLOW_PATH_BUFFER) ? small : malloc(len+24);
+        size_t pos = 0;
+        for (size_t i=0; i<len; i++) if (IS_DIGIT(text[i])) buffer[pos++] = text[i];
+        snprintf(buffer+pos, 24, "e%ld", exponent);
+        const double value = strtod(buffer, NULL);
+        if (buffer != small) free(buffer);
+        return value;
+}
+
+ParseResult parse_float(const char* text, const size_t len, double *const value) {
+        size_t i = 0;
+        int negative = 0;
+        if (len && (text[0] == '-' || text[0] == '+')) {
+                negative = (text[0] == '-');
+                i++;
+        }
+
+        if (is_word(text+i, len-i, "inf") || is_word(text+i, len-i, "infinity")) {
+                *value = negative ? -INFINITY : INFINITY;
+                return PARSE_OK;
+        }
+        if (is_word(text+i, len-i, "nan")) {
+                *value = NAN;
+                return PARSE_OK;
+        }
+
+        // the first MAX_SIGNIFICANT significant digits go in the mantissa
+        const size_t digits_start = i;
+        uint64_t mantissa = 0;
+        int significant = 0;
+        int truncated = 0; // some nonzero digits didn't fit
+        long exponent = 0; // of the mantissa
+        long fraction_digits = 0;
+        size_t nb_digits = 0;
+        int fractional = 0;
+        for (; i<len; i++) {
+                const char c = text[i];
+                if (c == '.' && !fractional) {
+                        fractional = 1;
+                        continue;
+                }
+                if (!IS_DIGIT(c)) break;
+                nb_digits++;
+                fraction_digits += fractional;
+                if (significant < MAX_SIGNIFICANT) {
+                        if (significant || c != '0') {
+                                mantissa = mantissa*10 + (c - '0');
+                                significant++;
+                        }
+                        exponent -= fractional;
+                } else {
+                        exponent += !fractional;
+                        truncated |= (c != '0');
+                }
+        }
+        const size_t digits_end = i;
+        if (nb_digits == 0) return PARSE_INVALID;
+
+        long explicit_exponent = 0;
+        if (i < len && (text[i] == 'e' || text[i] == 'E')) {
+                i++;
+                int negative_exponent = 0;
+                if (i < len && (text[i] == '-' || text[i] == '+')) {
+                        negative_exponent = (text[i] == '-');
+                        i++;
+                }
+                if (i == len) return PARSE_INVALID;
+                for (; i<len && IS_DIGIT(text[i]); i++) {
+                        if (explicit_exponent < MAX_EXPONENT) explicit_exponent = explicit_exponent*10 + (text[i] - '0');
+                }
+                if (negative_exponent) explicit_exponent = -explicit_exponent;
+        }
+        if (i != len) return PARSE_INVALID;
+        exponent += explicit_exponent;
+
+        double result;
+        if (mantissa == 0) result = 0;
+        else if (!truncated && mantissa <= MAX_EXACT_INT && exponent >= -MAX_EXACT_POW10 && exponent <= MAX_EXACT_POW10) {
+                // exact operands, hence a correctly rounded result (Clinger's fast path)
+                if (exponent >= 0) result = (double) mantissa * exact_pow10[exponent];
+                else result = (double) mantissa / exact_pow10[-exponent];
+        }
+        else result = slow_path(text+digits_start, digits_end-digits_start, explicit_exponent - fraction_digits);
+
+        *value = negative ? -result : result;
+        return PARSE_OK;
+}
+
+#undef IS_DIGIT
+#undef MAX_SIGNIFICANT
+#undef MAX_EXACT_POW10
+#undef MAX_EXACT_INT
+#undef MAX_EXPONENT
+#undef SLOW_PATH_BUFFER
+#undef DP_SIGNIFICAND_BITS
+#undef DP_HIDDEN_BIT
+#undef DP_EXPONENT_BIAS
@@ -0,0 +1,19 @@
+#include <stdlib.h>
+
+#include "interpreter/object.h"
+#include "interpreter/gc.h"
+
+#ifdef NAN_BOXING
+
+ObjInt* box_int(intmax_t value) {
+        // WARNING : hidden malloc()
+        ObjInt *const box = malloc(sizeof(*box));
+        box->value = value;
+        gc_track(&(box->gc), GC_INT, sizeof(*box));
+        return box;
+}
+void free_boxed_int(ObjInt* box) {
+        free(box);
+}
+
+#endif
@@ -0,0 +1,386 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "interpreter/optimizer.h"
+#include "interpreter/object.h"
+#include "interpreter/string.h"
+#include "interpreter/function.h"
+#include "identifiers_record.h"
+
+#define FOLD_MAX_STRING 4096 // longer repetitions of strings are left to run time
+
+#define IS_INT(obj) (OBJ_TYPE(obj) == TYPE_INT || OBJ_TYPE(obj) == TYPE_BOOL)
+#define IS_NUMBER(obj) (IS_INT(obj) || OBJ_TYPE(obj) == TYPE_FLOAT)
+#define AS_NUMBER(obj) ((OBJ_TYPE(obj) == TYPE_FLOAT) ? AS_FLOAT(obj) : (double) AS_INT(obj))
+
+typedef struct Context {
+        parser_info* prsinfo;
+        ObjFunction* function; // whose frame the code runs in, NULL for top-level code
+} Context;
+
+typedef struct NameSet {
+        size_t len;
+        size_t allocated;
+        char const** names; // internalized, compared by address
+} NameSet;
+
+typedef struct AddressList {
+        size_t len;
+        size_t allocated;
+        Address* addresses;
+} AddressList;
+
+static Node* optimize_code(Context *const ctx, Node* node);
+
+// ------------------------------ folding --------------------------------------
+
+static int literal_value(const Node* node, Object *const value) {
+        switch (node->operator) {
+                case OP_LITERAL_INT:
+                        *value = OBJ_INT(node->operands[0].obj.intval);
+                        return 1;
+                case OP_LITERAL_FLOAT:
+                        *value = OBJ_FLOAT(node->operands[0].obj.floatval);
+                        return 1;
+                case OP_LITERAL_TRUE:
+                        *value = OBJ_TRUE;
+                        return 1;
+                case OP_LITERAL_FALSE:
+                        *value = OBJ_FALSE;
+                        return 1;
+                case OP_LITERAL_NONE:
+                        *value = OBJ_NONE;
+                        return 1;
+                case OP_LITERAL_STR:
+                        *value = OBJ_STRING(node->operands[0].obj.strval);
+                        return 1;
+                default:
+                        return 0;
+        }
+}
+static int literal_truth(const Node* node) {
+        // the outcome of a predicate known before running it: 1 or 0, -1 if unknown
+        Object value;
+        if (!literal_value(node, &value)) return -1;
+        switch (OBJ_TYPE(value)) {
+                case TYPE_INT:
+                case TYPE_BOOL:
+                        return AS_INT(value) != 0;
+                case TYPE_NONE:
+                        return 0;
+                case TYPE_STRING:
+                        return AS_STRING(value)->len != 0;
+                default:
+                        return -1; // fails at run time
+        }
+}
+static Node* make_nop(Context *const ctx, const Node* from) {
+        Node *const node = allocateNode(ctx->prsinfo, 0);
+        *node = (Node) {.token=from->token, .operator=OP_NOP};
+        return node;
+}
+static Node* make_literal(Context *const ctx, Node *const from, const Object value) {
+        // <from> is kept when the value can't be folded
+        if (OBJ_TYPE(value) == TYPE_ERROR) return from;
+
+        Node *const node = allocateNode(ctx->prsinfo, 1);
+        *node = (Node) {.token=from->token};
+        switch (OBJ_TYPE(value)) {
+                case TYPE_INT:
+                        node->operator = OP_LITERAL_INT;
+                        node->operands[0].obj.intval = AS_INT(value);
+                        break;
+                case TYPE_FLOAT:
+                        node->operator = OP_LITERAL_FLOAT;
+                        node->operands[0].obj.floatval = AS_FLOAT(value);
+                        break;
+                case TYPE_BOOL:
+                        node->operator = AS_INT(value) ? OP_LITERAL_TRUE : OP_LITERAL_FALSE;
+                        break;
+                case TYPE_STRING:
+                        stringValue(AS_STRING(value)); // flattened once and for all
+                        node->operator = OP_LITERAL_STR;
+                        node->operands[0].obj.strval = AS_STRING(value);
+                        break;
+                default:
+                        return from;
+        }
+        return node;
+}
+
+/*
+The folding functions mirror the interpreter, but only for the operands it
+accepts: anything that would fail returns ERROR, and is left for the
+interpreter to report at run time.
+*/
+static Object fold_repeat(ObjString* str, const intmax_t amount) {
+        if (amount < 0 || (str->len && amount > FOLD_MAX_STRING / str->len)) return ERROR;
+        return OBJ_STRING(multiplyString(str, amount));
+}
+static Object fold_unary(const Operator operator, const Object a) {
+        switch (operator) {
+                case OP_UNARY_PLUS:
+                        if (IS_NUMBER(a)) return a;
+                        break;
+                case OP_UNARY_MINUS:
+                        if (IS_INT(a) && AS_INT(a) != INTMAX_MIN) return OBJ_INT(-AS_INT(a));
+                        if (OBJ_TYPE(a) == TYPE_FLOAT) return OBJ_FLOAT(-AS_FLOAT(a));
+                        break;
+                case OP_INVERT:
+                        if (IS_INT(a)) return OBJ_BOOL(!AS_INT(a));
+                        break;
+                default:
+                        break;
+        }
+        return ERROR;
+}
+static Object fold_binary(const Operator operator, const Object a, const Object b) {
+        const int ints = IS_INT(a) && IS_INT(b);
+        const int numbers = IS_NUMBER(a) && IS_NUMBER(b);
+        const int strings = OBJ_TYPE(a) == TYPE_STRING && OBJ_TYPE(b) == TYPE_STRING;
+        intmax_t result; // ints that overflow are left alone: bigints can't be literals
+
+        switch (operator) {
+                case OP_SUM:
+                        if (ints) return __builtin_add_overflow(AS_INT(a), AS_INT(b), &result) ? ERROR : OBJ_INT(result);
+                        if (numbers) return OBJ_FLOAT(AS_NUMBER(a)+AS_NUMBER(b));
+                        if (strings) return OBJ_STRING(concatenateStrings(AS_STRING(a), AS_STRING(b)));
+                        break;
+                case OP_DIFFERENCE:
+                        if (ints) return __builtin_sub_overflow(AS_INT(a), AS_INT(b), &result) ? ERROR : OBJ_INT(result);
+                        if (numbers) return OBJ_FLOAT(AS_NUMBER(a)-AS_NUMBER(b));
+                        break;
+                case OP_PRODUCT:
+                        if (ints) return __builtin_mul_overflow(AS_INT(a), AS_INT(b), &result) ? ERROR : OBJ_INT(result);
+                        if (numbers) return OBJ_FLOAT(AS_NUMBER(a)*AS_NUMBER(b));
+                        if (OBJ_TYPE(a) == TYPE_STRING && IS_INT(b)) return fold_repeat(AS_STRING(a), AS_INT(b));
+                        if (IS_INT(a) && OBJ_TYPE(b) == TYPE_STRING) return fold_repeat(AS_STRING(b), AS_INT(a));
+                        break;
+                case OP_DIVISION:
+                        if (numbers) return OBJ_FLOAT(AS_NUMBER(a)/AS_NUMBER(b));
+                        break;
+                case OP_EQ:
+                        if (ints) return OBJ_BOOL(AS_INT(a) == AS_INT(b));
+                        if (strings) return OBJ_BOOL(AS_STRING(a)->len == AS_STRING(b)->len
+                                && !memcmp(stringValue(AS_STRING(a)), stringValue(AS_STRING(b)), AS_STRING(a)->len));
+                        if (OBJ_TYPE(a) == TYPE_NONE && OBJ_TYPE(b) == TYPE_NONE) return OBJ_TRUE;
+                        break;
+                case OP_LT:
+                        if (ints) return OBJ_BOOL(AS_INT(a) < AS_INT(b));
+                        if (numbers) return OBJ_BOOL(AS_NUMBER(a) < AS_NUMBER(b));
+                        break;
+                case OP_LE:
+                        if (ints) return OBJ_BOOL(AS_INT(a) <= AS_INT(b));
+                        if (numbers) return OBJ_BOOL(AS_NUMBER(a) <= AS_NUMBER(b));
+                        break;
+                default:
+                        break;
+        }
+        return ERROR;
+}
+static void optimize_function(Context *const ctx, ObjFunction *const fun) {
+        Context inner = {.prsinfo=ctx->prsinfo, .function=fun};
+        fun->body = optimize_code(&inner, fun->body);
+}
+static Node* fold(Context *const ctx, Node* node) {
+        // bottom-up, so that folded operands can fold their parent in turn
+        if (node == NULL) return NULL;
+        if (node->operator == OP_LITERAL_FUNCTION) {
+                optimize_function(ctx, node->operands[0].obj.funval);
+                return node;
+        }
+
+        const ChildRange children = childRange(node);
+        for (uintptr_t i=children.first; i<children.end; i++) node->operands[i].nd = fold(ctx, node->operands[i].nd);
+
+        Object a, b;
+        switch (node->operator) {
+                case OP_UNARY_PLUS:
+                case OP_UNARY_MINUS:
+                case OP_INVERT:
+                        if (!literal_value(node->operands[0].nd, &a)) return node;
+                        return make_literal(ctx, node, fold_unary(node->operator, a));
+                case OP_SUM:
+                case OP_DIFFERENCE:
+                case OP_PRODUCT:
+                case OP_DIVISION:
+                case OP_EQ:
+                case OP_LT:
+                case OP_LE:
+                        if (!literal_value(node->operands[0].nd, &a) || !literal_value(node->operands[1].nd, &b)) return node;
+                        return make_literal(ctx, node, fold_binary(node->operator, a, b));
+                case OP_IFELSE:
+                        switch (literal_truth(node->operands[0].nd)) {
+                                case 1:
+                                        return node->operands[1].nd;
+                                case 0:
+                                        return (node->operands[2].nd != NULL) ? node->operands[2].nd : make_nop(ctx, node);
+                                default:
+                                        return node;
+                        }
+                case OP_WHILE:
+                        if (literal_truth(node->operands[0].nd) == 0) return make_nop(ctx, node);
+                        return node;
+                default:
+                        return node;
+        }
+}
+
+// ------------------------------ hoisting -------------------------------------
+
+static void add_name(NameSet *const set, char const* name) {
+        for (size_t i=0; i<set->len; i++) if (set->names[i] == name) return;
+        if (set->len >= set->allocated) {
+                set->allocated = set->allocated ? set->allocated*2 : 8;
+                set->names = reallocarray(set->names, set->allocated, sizeof(set->names[0]));
+        }
+        set->names[set->len++] = name;
+}
+static int has_name(const NameSet* set, char const* name) {
+        for (size_t i=0; i<set->len; i++) if (set->names[i] == name) return 1;
+        return 0;
+}
+static void add_address(AddressList *const list, const Address addr) {
+        if (list->len >= list->allocated) {
+                list->allocated = list->allocated ? list->allocated*2 : 4;
+                list->addresses = reallocarray(list->addresses, list->allocated, sizeof(list->addresses[0]));
+        }
+        list->addresses[list->len++] = addr;
+}
+
+static int is_pure(const Operator operator) {
+        switch (operator) {
+                case OP_UNARY_PLUS:
+                case OP_UNARY_MINUS:
+                case OP_INVERT:
+                case OP_SUM:
+                case OP_DIFFERENCE:
+                case OP_PRODUCT:
+                case OP_DIVISION:
+                case OP_AND:
+                case OP_OR:
+                case OP_EQ:
+                case OP_LT:
+                case OP_LE:
+                        return 1;
+                default:
+                        return 0;
+        }
+}
+static void collect_assigned(const Node* node, NameSet *const assigned) {
+        // calls can't assign our variables: a function only ever writes to its own frame
+        if (node == NULL || node->operator <= LAST_OP_LEAF) return;
+
+        switch (node->operator) {
+                case OP_AFFECT:
+                case OP_IADD:
+                case OP_ISUB:
+                case OP_IMUL:
+                case OP_IDIV:
+                case OP_IADD_INT_INT:
+                case OP_IADD_FLOAT_FLOAT:
+                case OP_ISUB_INT_INT:
+                case OP_ISUB_FLOAT_FLOAT:
+                        add_name(assigned, node->operands[0].nd->token.source);
+                        break;
+                default:
+                        break;
+        }
+
+        const ChildRange children = childRange(node);
+        for (uintptr_t i=children.first; i<children.end; i++) collect_assigned(node->operands[i].nd, assigned);
+}
+static int is_invariant(const Node* node, const NameSet* assigned) {
+        if (node->operator <= LAST_OP_LITERAL) return 1;
+        if (node->operator == OP_VARIABLE) return !has_name(assigned, node->token.source);
+        if (node->operator == OP_INVARIANT) return 1; // hoisted out of an enclosing loop, which contains this one
+        if (!is_pure(node->operator)) return 0;
+
+        const ChildRange children = childRange(node);
+        for (uintptr_t i=children.first; i<children.end; i++) {
+                if (!is_invariant(node->operands[i].nd, assigned)) return 0;
+        }
+        return 1;
+}
+static Address new_slot(Context *const ctx) {
+        if (ctx->function != NULL) return (Address) {.depth=0, .slot=ctx->function->frame_size++};
+
+        // top-level code runs in the global frame; the name can't clash with any identifier
+        char name[32];
+        const int len = snprintf(name, sizeof(name), "$hoisted%lu", (unsigned long) nb_globals(ctx->prsinfo));
+        char const* key = internalize(&(ctx->prsinfo->lxinfo.record), name, len);
+        return (Address) {.depth=ADDR_GLOBAL, .slot=record_global(ctx->prsinfo, key)};
+}
+static Node* hoist(Context *const ctx, Node* node, const NameSet* assigned, AddressList *const hoisted) {
+        // wraps the largest invariant expressions; they are still evaluated where they are, but only once
+        if (node == NULL || node->operator <= LAST_OP_LEAF || node->operator == OP_INVARIANT) return node;
+
+        if (is_pure(node->operator) && is_invariant(node, assigned)) {
+                const Address addr = new_slot(ctx);
+                add_address(hoisted, addr);
+                Node *const wrapper = allocateNode(ctx->prsinfo, 2);
+                *wrapper = (Node) {.token=node->token, .operator=OP_INVARIANT};
+                wrapper->operands[0].nd = node;
+                wrapper->operands[1].addr = addr;
+                return wrapper;
+        }
+
+        const ChildRange children = childRange(node);
+        for (uintptr_t i=children.first; i<children.end; i++) node->operands[i].nd = hoist(ctx, node->operands[i].nd, assigned, hoisted);
+        return node;
+}
+static Node* hoist_invariants(Context *const ctx, Node *const loop) {
+        // returns the statement that must run before each entry in the loop, or NULL
+        NameSet assigned = {0};
+        AddressList hoisted = {0};
+        Node* forget = NULL;
+
+        collect_assigned(loop, &assigned);
+        loop->operands[0].nd = hoist(ctx, loop->operands[0].nd, &assigned, &hoisted);
+        loop->operands[1].nd = hoist(ctx, loop->operands[1].nd, &assigned, &hoisted);
+
+        if (hoisted.len) {
+                forget = allocateNode(ctx->prsinfo, hoisted.len+1);
+                *forget = (Node) {.token=loop->token, .operator=OP_FORGET};
+                forget->operands[0].len = hoisted.len;
+                for (size_t i=0; i<hoisted.len; i++) forget->operands[i+1].addr = hoisted.addresses[i];
+        }
+
+        free(assigned.names);
+        free(hoisted.addresses);
+        return forget;
+}
+static Node* optimize_loops(Context *const ctx, Node* node) {
+        // top-down, so that expressions are hoisted out of the outermost loop possible
+        if (node == NULL || node->operator <= LAST_OP_LEAF) return node;
+
+        Node* forget = NULL;
+        if (node->operator == OP_WHILE) forget = hoist_invariants(ctx, node);
+
+        const ChildRange children = childRange(node);
+        for (uintptr_t i=children.first; i<children.end; i++) node->operands[i].nd = optimize_loops(ctx, node->operands[i].nd);
+
+        if (forget == NULL) return node;
+        Node *const block = allocateNode(ctx->prsinfo, 3);
+        *block = (Node) {.token=node->token, .operator=OP_BLOCK};
+        block->operands[0].len = 2;
+        block->operands[1].nd = forget;
+        block->operands[2].nd = node;
+        return block;
+}
+
+// ------------------------------ entry point ----------------------------------
+
+static Node* optimize_code(Context *const ctx, Node* node) {
+        return optimize_loops(ctx, fold(ctx, node));
+}
+Node* optimize(parser_info *const prsinfo, Node* root) {
+        Context ctx = {.prsinfo=prsinfo, .function=NULL};
+        return optimize_code(&ctx, root);
+}
+
+#undef FOLD_MAX_STRING
+#undef IS_INT
+#undef IS_NUMBER
+#undef AS_NUMBER
@@ -7,9 +7,11 @@
 #include "interpreter/object.h"
 #include "interpreter/string.h"
 #include "interpreter/function.h"
+#include "interpreter/numconv.h"
+#include "interpreter/jit.h"
 #include "error.h"
 
-#define ALLOCATE_SIMPLE_NODE(operator) (allocateNode(nb_operands[operator]))
+#define ALLOCATE_SIMPLE_NODE(operator) (allocateNode(state, nb_operands[operator]))
 
 typedef enum Precedence {
         PREC_NONE = 1,
@@ -31,11 +33,19 @@ typedef struct BinaryParseRule {
 } BinaryParseRule;
 
 static Node* parseExpression(parser_info *const state, const Precedence precedence);
+static Node* _parse_statement(parser_info *const state);
 static Node* prefixParseError(parser_info *const state);
 static Node* infixParseError(parser_info *const state, Node *const root);
 
+typedef struct ResolverRecord {
+        size_t allocated;
+        size_t len;
+        char const* keys[]; // the index of a key is its slot
+} ResolverRecord;
+
 static const uintptr_t nb_operands[LEN_OPERATORS] = {
-        [OP_VARIABLE] = 0,
+        [OP_VARIABLE] = UINTPTR_MAX, // addresses, not nodes
+        [OP_FORGET] = UINTPTR_MAX, // addresses, not nodes
         [OP_LITERAL_INT] = 1,
         [OP_LITERAL_FLOAT] = 1,
         [OP_LITERAL_TRUE] = 0,
@@ -47,6 +57,7 @@ static const uintptr_t nb_operands[LEN_OPERATORS] = {
         [OP_UNARY_PLUS] = 1,
         [OP_UNARY_MINUS] = 1,
         [OP_INVERT] = 1,
+        [OP_INVARIANT] = 1, // followed by an address
         [OP_RETURN] = 1,
 
         [OP_SUM] = 2,
@@ -64,66 +75,131 @@ static const uintptr_t nb_operands[LEN_OPERATORS] = {
         [OP_IMUL] = 2,
         [OP_IDIV] = 2,
 
+        [OP_SUM_INT_INT] = 2,
+        [OP_SUM_FLOAT_FLOAT] = 2,
+        [OP_DIFFERENCE_INT_INT] = 2,
+        [OP_DIFFERENCE_FLOAT_FLOAT] = 2,
+        [OP_PRODUCT_INT_INT] = 2,
+        [OP_PRODUCT_FLOAT_FLOAT] = 2,
+        [OP_DIVISION_FLOAT_FLOAT] = 2,
+        [OP_EQ_INT_INT] = 2,
+        [OP_LT_INT_INT] = 2,
+        [OP_LT_FLOAT_FLOAT] = 2,
+        [OP_LE_INT_INT] = 2,
+        [OP_LE_FLOAT_FLOAT] = 2,
+        [OP_IADD_INT_INT] = 2,
+        [OP_IADD_FLOAT_FLOAT] = 2,
+        [OP_ISUB_INT_INT] = 2,
+        [OP_ISUB_FLOAT_FLOAT] = 2,
+
         [OP_CALL] = UINTPTR_MAX,
 
         [OP_NOP] = 0,
 
         [OP_BLOCK] = UINTPTR_MAX,
         [OP_IFELSE] = 3, // predicate, if_stmt, else_stmt
-        [OP_WHILE] = 2, // predicate, loop body
+        [OP_WHILE] = 2, // predicate, loop body, followed by the state of the JIT
 }; // set to UINTPTR_MAX for a variable number of operands
 
-static inline void refresh(parser_info *const prsinfo) {
-        // call to guarantee the last produced token is not stale
-        if (prsinfo->stale) {
-                prsinfo->last_produced = lex(&(prsinfo->lxinfo));
-                prsinfo->stale = 0;
-        }
+static inline const Token* peek(parser_info *const prsinfo) {
+        return peek_token(&(prsinfo->lxinfo), 0);
 }
-static inline LocalizedToken consume(parser_info *const prsinfo) {
-        refresh(prsinfo);
-        prsinfo->stale = 1;
-        return prsinfo->last_produced;
+static inline Token consume(parser_info *const prsinfo) {
+        return next_token(&(prsinfo->lxinfo));
 }
 static inline TokenType getTtype(parser_info *const prsinfo) {
-        refresh(prsinfo);
-        return prsinfo->last_produced.tok.type;
-}
-static Node* allocateNode(const uintptr_t nb_children) {
-        return malloc(offsetof(Node, operands) + sizeof(Node*)*nb_children);
+        return peek(prsinfo)->type;
 }
-static Node* reallocateNode(Node* nd, const uintptr_t nb_children) {
-        return realloc(nd, offsetof(Node, operands) + sizeof(Node*)*nb_children);
+Node* allocateNode(parser_info *const prsinfo, const uintptr_t nb_children) {
+        return arena_alloc(&(prsinfo->nodes), offsetof(Node, operands) + sizeof(((Node*)NULL)->operands[0])*nb_children);
 }
-void freeNode(Node* node) {
-        if (node == NULL) return;
-
-        if (node->operator > LAST_OP_LITERAL) {
-                uintptr_t nb = nb_operands[node->operator];
-                uintptr_t index;
-                if (nb == UINTPTR_MAX) index = 1, nb = node->operands[0].len;
-                else index = 0;
-
-                for (; index<nb; index++) freeNode(node->operands[index].nd);
+static void push_pending(parser_info *const prsinfo, Node *const node) {
+        if (prsinfo->pending_top >= prsinfo->pending_len) {
+                prsinfo->pending_len *= 2;
+                prsinfo->pending = reallocarray(prsinfo->pending, prsinfo->pending_len, sizeof(prsinfo->pending[0]));
+        }
+        prsinfo->pending[prsinfo->pending_top++] = node;
+}
+static Node* pop_pending(parser_info *const prsinfo, const size_t mark, const Token token, const Operator operator) {
+        // builds a node of variable arity from the children pushed since <mark>
+        const uintptr_t count = prsinfo->pending_top - mark;
+        Node *const node = allocateNode(prsinfo, count + 1); // add one, for the length of the array
+        *node = (Node) {.token=token, .operator=operator};
+        node->operands[0].len = count;
+        for (uintptr_t i=0; i<count; i++) node->operands[i+1].nd = prsinfo->pending[mark+i];
+        prsinfo->pending_top = mark;
+        return node;
+}
+ChildRange childRange(const Node* node) {
+        if (node->operator <= LAST_OP_LEAF) return (ChildRange) {.first=0, .end=0};
+
+        const uintptr_t nb = nb_operands[node->operator];
+        if (nb == UINTPTR_MAX) return (ChildRange) {.first=1, .end=node->operands[0].len+1};
+        else return (ChildRange) {.first=0, .end=nb};
+}
+static ResolverRecord* mk_record(void) {
+        ResolverRecord *const record = malloc(offsetof(ResolverRecord, keys) + 16*sizeof(char const*));
+        record->allocated = 16;
+        record->len = 0;
+        return record;
+}
+static void free_record(ResolverRecord* record) {
+        free(record);
+}
+static ResolverRecord* add_key(ResolverRecord* record, char const* key) {
+        if (record->len >= record->allocated) {
+                record->allocated *= 2;
+                record = realloc(record, offsetof(ResolverRecord, keys) + record->allocated*sizeof(char const*));
         }
-        free(node);
+        record->keys[record->len++] = key;
+        return record;
 }
+static uint32_t lookup_key(const ResolverRecord* record, char const* key) {
+        // keys are internalized, comparing pointers is enough
+        for (size_t i=record->len; i-->0; ) if (record->keys[i] == key) return i;
+        return UINT32_MAX;
+}
+
 void mk_parser_info(parser_info *const prsinfo) {
-        prsinfo->stale = 1;
         prsinfo->func_def_depth = 0;
+        prsinfo->globals = mk_record();
+        mk_arena(&(prsinfo->nodes));
+        prsinfo->pending_len = 16;
+        prsinfo->pending_top = 0;
+        prsinfo->pending = malloc(prsinfo->pending_len*sizeof(prsinfo->pending[0]));
+}
+void restart_parser(parser_info *const prsinfo) {
+        prsinfo->func_def_depth = 0;
+        prsinfo->pending_top = 0;
 }
 void del_parser_info(parser_info *const prsinfo) {
-        // nop
+        free_record(prsinfo->globals);
+        del_arena(&(prsinfo->nodes));
+        free(prsinfo->pending);
+}
+size_t nb_globals(const parser_info* prsinfo) {
+        return prsinfo->globals->len;
+}
+char const* global_name(const parser_info* prsinfo, const uint32_t slot) {
+        return prsinfo->globals->keys[slot];
+}
+uint32_t record_global(parser_info *const prsinfo, char const* key) {
+        uint32_t slot = lookup_key(prsinfo->globals, key);
+        if (slot == UINT32_MAX) {
+                slot = prsinfo->globals->len;
+                prsinfo->globals = add_key(prsinfo->globals, key);
+        }
+        return slot;
 }
 
 // --------------------- prefix parse functions --------------------------------
 
 static Node* prefixParseError(parser_info *const state) {
-        Error(&(state->last_produced), "Syntax error: unexpected token at this place.\n");
+        Error(peek(state), "Syntax error: unexpected token at this place.\n");
         return NULL;
 }
 static Node* unary_plus(parser_info *const state) {
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_UNARY);
         if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_UNARY_PLUS);
@@ -132,7 +208,7 @@ static Node* unary_plus(parser_info *const state) {
         return new;
 }
 static Node* unary_minus(parser_info *const state) {
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_UNARY);
         if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_UNARY_MINUS);
@@ -143,12 +219,16 @@ static Node* unary_minus(parser_info *const state) {
 static Node* integer(parser_info *const state) {
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_LITERAL_INT);
         *new = (Node) {.token=consume(state), .operator=OP_LITERAL_INT};
-        new->operands[0].obj.intval = atoll(new->token.tok.source);
+        if (parse_int(new->token.source, new->token.length, &(new->operands[0].obj.intval)) != PARSE_OK) {
+                // the lexer only lets digits through
+                Error(&(new->token), "Syntax error: integer literal too large.\n");
+                return NULL;
+        }
         return new;
 }
 static Node* boolean(parser_info *const state) {
-        LocalizedToken tk = consume(state);
-        if (tk.tok.type == TOKEN_TRUE) {
+        Token tk = consume(state);
+        if (tk.type == TOKEN_TRUE) {
                 Node *const new = ALLOCATE_SIMPLE_NODE(OP_LITERAL_TRUE);
                 *new = (Node) {.token=tk, .operator=OP_LITERAL_TRUE};
                 return new;
@@ -162,13 +242,13 @@ static Node* boolean(parser_info *const state) {
 static Node* fpval(parser_info *const state) {
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_LITERAL_FLOAT);
         *new = (Node) {.token=consume(state), .operator=OP_LITERAL_FLOAT};
-        new->operands[0].obj.intval = atof(new->token.tok.source);
+        parse_float(new->token.source, new->token.length, &(new->operands[0].obj.floatval));
         return new;
 }
 static Node* string(parser_info *const state) {
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_LITERAL_STR);
         *new = (Node) {.token=consume(state), .operator=OP_LITERAL_STR};
-        new->operands[0].obj.strval = makeString(new->token.tok.source+1, new->token.tok.length-2);
+        new->operands[0].obj.strval = makeString(new->token.source+1, new->token.length-2);
         return new;
 }
 static Node* grouping(parser_info *const state) {
@@ -182,7 +262,7 @@ static Node* grouping(parser_info *const state) {
         return operand;
 }
 static Node* invert(parser_info *const state) {
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_UNARY);
         if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_INVERT);
@@ -196,8 +276,10 @@ static Node* none(parser_info *const state) {
         return new;
 }
 static Node* identifier(parser_info *const state) {
-        Node *const new = ALLOCATE_SIMPLE_NODE(OP_VARIABLE);
+        // the addresses are filled in by the resolver
+        Node *const new = allocateNode(state, 1);
         *new = (Node) {.token=consume(state), .operator=OP_VARIABLE};
+        new->operands[0].len = 0;
         return new;
 }
 static Node* function(parser_info *const state) {
@@ -215,7 +297,7 @@ static Node* function(parser_info *const state) {
         while (getTtype(state) != TOKEN_PCLOSE) {
                 if (getTtype(state) == TOKEN_IDENTIFIER) {
                         func = reallocFunction(func, func->arity+1);
-                        func->arguments[func->arity++] = consume(state).tok.source;
+                        func->arguments[func->arity++] = consume(state).source;
                 }
 
                 if (getTtype(state) == TOKEN_COMMA) consume(state);
@@ -227,12 +309,12 @@ static Node* function(parser_info *const state) {
         consume(state);
 
         state->func_def_depth++;
-        if ((func->body = parse_statement(state)) == NULL) {
-                freeNode(fct);
+        if ((func->body = _parse_statement(state)) == NULL) {
                 free_function(func);
                 return NULL;
         }
         state->func_def_depth--;
+        registerFunction(func);
         fct->operands[0].obj.funval = func;
         return fct;
 }
@@ -240,16 +322,13 @@ static Node* function(parser_info *const state) {
 // --------------------- infix parse functions ---------------------------------
 
 static Node* infixParseError(parser_info *const state, Node *const root) {
-        Error(&(state->last_produced), "Syntax error: unexpected token at this place.\n");
+        Error(peek(state), "Syntax error: unexpected token at this place.\n");
         return NULL;
 }
 static Node* binary_plus(parser_info *const state, Node *const root) {
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_ADD);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_SUM);
         *new = (Node) {.token=operator, .operator=OP_SUM};
         new->operands[0].nd = root;
@@ -257,12 +336,9 @@ static Node* binary_plus(parser_info *const state, Node *const root) {
         return new;
 }
 static Node* binary_minus(parser_info *const state, Node *const root) {
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_ADD);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_DIFFERENCE);
         *new = (Node) {.token=operator, .operator=OP_DIFFERENCE};
         new->operands[0].nd = root;
@@ -270,12 +346,9 @@ static Node* binary_minus(parser_info *const state, Node *const root) {
         return new;
 }
 static Node* binary_star(parser_info *const state, Node *const root) {
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_MUL);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_PRODUCT);
         *new = (Node) {.token=operator, .operator=OP_PRODUCT};
         new->operands[0].nd = root;
@@ -283,12 +356,9 @@ static Node* binary_star(parser_info *const state, Node *const root) {
         return new;
 }
 static Node* binary_slash(parser_info *const state, Node *const root) {
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_MUL);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_DIVISION);
         *new = (Node) {.token=operator, .operator=OP_DIVISION};
         new->operands[0].nd = root;
@@ -296,12 +366,9 @@ static Node* binary_slash(parser_info *const state, Node *const root) {
         return new;
 }
 static Node* binary_and(parser_info *const state, Node *const root) {
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_AND);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_AND);
         *new = (Node) {.token=operator, .operator=OP_AND};
         new->operands[0].nd = root;
@@ -309,12 +376,9 @@ static Node* binary_and(parser_info *const state, Node *const root) {
         return new;
 }
 static Node* binary_or(parser_info *const state, Node *const root) {
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_OR);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_OR);
         *new = (Node) {.token=operator, .operator=OP_OR};
         new->operands[0].nd = root;
@@ -322,12 +386,9 @@ static Node* binary_or(parser_info *const state, Node *const root) {
         return new;
 }
 static Node* lt(parser_info *const state, Node *const root) {
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_COMPARISON);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_LT);
         *new = (Node) {.token=operator, .operator=OP_LT};
         new->operands[0].nd = root;
@@ -335,12 +396,9 @@ static Node* lt(parser_info *const state, Node *const root) {
         return new;
 }
 static Node* le(parser_info *const state, Node *const root) {
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_COMPARISON);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_LE);
         *new = (Node) {.token=operator, .operator=OP_LE};
         new->operands[0].nd = root;
@@ -349,9 +407,8 @@ static Node* le(parser_info *const state, Node *const root) {
 }
 static Node* gt(parser_info *const state, Node *const root) {
         // > is implemented as !(<=)
-        refresh(state);
         // not how we DON'T consume the token; `le` will do it
-        const LocalizedToken operator = state->last_produced;
+        const Token operator = *peek(state);
         Node* operand = le(state, root);
         if (operand == NULL) return NULL;
 
@@ -362,9 +419,8 @@ static Node* gt(parser_info *const state, Node *const root) {
 }
 static Node* ge(parser_info *const state, Node *const root) {
         // >= is implemented as !(<)
-        refresh(state);
         // not how we DON'T consume the token; `lt` will do it
-        const LocalizedToken operator = state->last_produced;
+        const Token operator = *peek(state);
         Node* operand = lt(state, root);
         if (operand == NULL) return NULL;
 
@@ -374,12 +430,9 @@ static Node* ge(parser_info *const state, Node *const root) {
         return new;
 }
 static Node* eq(parser_info *const state, Node *const root) {
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_COMPARISON);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_EQ);
         *new = (Node) {.token=operator, .operator=OP_EQ};
         new->operands[0].nd = root;
@@ -388,9 +441,8 @@ static Node* eq(parser_info *const state, Node *const root) {
 }
 static Node* ne(parser_info *const state, Node *const root) {
         // != is implemented as !(==)
-        refresh(state);
         // not how we DON'T consume the token; `eq` will do it
-        const LocalizedToken operator = state->last_produced;
+        const Token operator = *peek(state);
         Node* operand = eq(state, root);
         if (operand == NULL) return NULL;
 
@@ -402,12 +454,9 @@ static Node* ne(parser_info *const state, Node *const root) {
 static Node* affect(parser_info *const state, Node *const root) {
         if (root->operator != OP_VARIABLE) return infixParseError(state, root);
 
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_AFFECT-1);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_AFFECT);
         *new = (Node) {.token=operator, .operator=OP_AFFECT};
         new->operands[0].nd = root;
@@ -416,40 +465,34 @@ static Node* affect(parser_info *const state, Node *const root) {
 }
 static Node* call(parser_info *const state, Node *const root) {
         // [count, fnode, argnode...]
-        uintptr_t count = 1; // function node
-        Node* new = allocateNode(count + 1);
-
-        new->token = consume(state);
-        new->operator = OP_CALL;
-        new->operands[1].nd = root;
+        const size_t mark = state->pending_top;
+        const Token token = consume(state);
+        push_pending(state, root);
 
         while (getTtype(state) != TOKEN_PCLOSE) {
                 Node* arg = parseExpression(state, PREC_NONE);
                 if (arg == NULL) {
-                        new->operands[0].len = count;
-                        freeNode(new);
+                        state->pending_top = mark;
                         return NULL;
                 }
-                new = reallocateNode(new, ++count+1);
-                new->operands[count].nd = arg;
+                push_pending(state, arg);
 
                 if (getTtype(state) == TOKEN_COMMA) consume(state);
-                else if (getTtype(state) != TOKEN_PCLOSE) return infixParseError(state, new);
+                else if (getTtype(state) != TOKEN_PCLOSE) {
+                        state->pending_top = mark;
+                        return infixParseError(state, root);
+                }
         }
         consume(state);
-        new->operands[0].len = count;
-        return new;
+        return pop_pending(state, mark, token, OP_CALL);
 
 }
 static Node* iadd(parser_info *const state, Node *const root) {
         if (root->operator != OP_VARIABLE) return infixParseError(state, root);
 
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_ADD);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_IADD);
         *new = (Node) {.token=operator, .operator=OP_IADD};
         new->operands[0].nd = root;
@@ -459,12 +502,9 @@ static Node* iadd(parser_info *const state, Node *const root) {
 static Node* isub(parser_info *const state, Node *const root) {
         if (root->operator != OP_VARIABLE) return infixParseError(state, root);
 
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_ADD);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_ISUB);
         *new = (Node) {.token=operator, .operator=OP_ISUB};
         new->operands[0].nd = root;
@@ -474,12 +514,9 @@ static Node* isub(parser_info *const state, Node *const root) {
 static Node* imul(parser_info *const state, Node *const root) {
         if (root->operator != OP_VARIABLE) return infixParseError(state, root);
 
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_MUL);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_IMUL);
         *new = (Node) {.token=operator, .operator=OP_IMUL};
         new->operands[0].nd = root;
@@ -489,12 +526,9 @@ static Node* imul(parser_info *const state, Node *const root) {
 static Node* idiv(parser_info *const state, Node *const root) {
         if (root->operator != OP_VARIABLE) return infixParseError(state, root);
 
-        const LocalizedToken operator = consume(state);
+        const Token operator = consume(state);
         Node* operand = parseExpression(state, PREC_MUL);
-        if (operand == NULL) {
-                freeNode(root);
-                return NULL;
-        }
+        if (operand == NULL) return NULL;
         Node *const new = ALLOCATE_SIMPLE_NODE(OP_IDIV);
         *new = (Node) {.token=operator, .operator=OP_IDIV};
         new->operands[0].nd = root;
@@ -564,8 +598,7 @@ static Node* simple_statement(parser_info *const state) {
         Node* stmt = parseExpression(state, PREC_NONE);
         if (stmt == NULL) return NULL;
         if (getTtype(state) != TOKEN_SEMICOLON) {
-                Error(&(state->last_produced), "Syntax error: expected a `;`.\n");
-                freeNode(stmt);
+                Error(peek(state), "Syntax error: expected a `;`.\n");
                 stmt = NULL;
         } else {
                 consume(state);
@@ -574,60 +607,42 @@ static Node* simple_statement(parser_info *const state) {
 }
 
 static Node* block_statement(parser_info *const state) {
-        uintptr_t nb_children = 0;
-        Node* stmt = allocateNode(nb_children + 1); // add one, for the length of the array
-        stmt->token = consume(state);
-        stmt->operator = OP_BLOCK;
+        const size_t mark = state->pending_top;
+        const Token token = consume(state);
         while (getTtype(state) != TOKEN_BCLOSE) {
-                Node* substmt = parse_statement(state);
+                Node* substmt = _parse_statement(state);
                 if (substmt == NULL) {
-                        stmt->operands[0].len = nb_children;
-                        freeNode(stmt);
+                        state->pending_top = mark;
                         return NULL;
                 }
-                stmt = reallocateNode(stmt, ++nb_children+1);
-                stmt->operands[nb_children].nd = substmt;
+                push_pending(state, substmt);
         }
-        stmt->operands[0].len = nb_children;
         consume(state);
-        return stmt;
+        return pop_pending(state, mark, token, OP_BLOCK);
 }
 
 static Node* ifelse_statement(parser_info *const state) {
         Node* new = ALLOCATE_SIMPLE_NODE(OP_IFELSE);
-        *new = (Node) {.token=state->last_produced, .operator=OP_IFELSE};
+        *new = (Node) {.token=*peek(state), .operator=OP_IFELSE};
         consume(state);
-        if ((new->operands[0].nd = parseExpression(state, PREC_NONE)) == NULL) {
-                freeNode(new);
-                return NULL;
-        }
-        if ((new->operands[1].nd = parse_statement(state)) == NULL) {
-                freeNode(new);
-                return NULL;
-        }
+        if ((new->operands[0].nd = parseExpression(state, PREC_NONE)) == NULL) return NULL;
+        if ((new->operands[1].nd = _parse_statement(state)) == NULL) return NULL;
         if (getTtype(state) == TOKEN_ELSE) {
                 consume(state);
-                if ((new->operands[2].nd = parse_statement(state)) == NULL) {
-                        freeNode(new);
-                        return NULL;
-                }
+                if ((new->operands[2].nd = _parse_statement(state)) == NULL) return NULL;
         }
         else new->operands[2].nd = NULL;
         return new;
 }
 
 static Node* while_statement(parser_info *const state) {
-        Node* new = ALLOCATE_SIMPLE_NODE(OP_WHILE);
-        *new = (Node) {.token=state->last_produced, .operator=OP_WHILE};
+        Node* new = allocateNode(state, JIT_LOOP+1);
+        *new = (Node) {.token=*peek(state), .operator=OP_WHILE};
+        new->operands[JIT_HOTNESS].len = 0;
+        new->operands[JIT_LOOP].jit = NULL;
         consume(state);
-        if ((new->operands[0].nd = parseExpression(state, PREC_NONE)) == NULL) {
-                freeNode(new);
-                return NULL;
-        }
-        if ((new->operands[1].nd = parse_statement(state)) == NULL) {
-                freeNode(new);
-                return NULL;
-        }
+        if ((new->operands[0].nd = parseExpression(state, PREC_NONE)) == NULL) return NULL;
+        if ((new->operands[1].nd = _parse_statement(state)) == NULL) return NULL;
         return new;
 }
 
@@ -643,14 +658,11 @@ static Node* return_statement(parser_info *const state) {
         if (!state->func_def_depth) return prefixParseError(state);
 
         Node* stmt = ALLOCATE_SIMPLE_NODE(OP_RETURN);
-        *stmt = (Node) {.token=state->last_produced, .operator=OP_RETURN};
+        *stmt = (Node) {.token=*peek(state), .operator=OP_RETURN};
         consume(state);
 
         Node* arg = simple_statement(state);
-        if (arg == NULL) {
-                freeNode(stmt);
-                return NULL;
-        }
+        if (arg == NULL) return NULL;
         else {
                 stmt->operands[0].nd = arg;
                 LOG("out");
@@ -661,7 +673,7 @@ static Node* return_statement(parser_info *const state) {
 
 // ------------------ end statement handlers -----------------------------------
 
-Node* parse_statement(parser_info *const state) {
+static Node* _parse_statement(parser_info *const state) {
         static const StatementHandler handlers[TOKEN_EOF] = {
                 [TOKEN_BOPEN] = block_statement,
                 [TOKEN_IF] = ifelse_statement,
@@ -679,4 +691,142 @@ Node* parse_statement(parser_info *const state) {
         else return handler(state);
 }
 
+// ------------------ begin resolver ------------------------------------------
+
+/*
+The resolver runs on complete top-level statements, and turns every variable
+into a list of addresses to try in order at runtime: it walks the scopes from
+the innermost function to the global scope. Scoping is thus lexical: the
+variables of a caller are out of reach, unless the callee is defined inside it.
+A name that is assigned somewhere in a function is one of its locals, but until
+it is actually assigned, reads fall back to the enclosing scopes; this is how
+`x = x + 3;` reads an outer `x`. Parameters are always bound, so the search
+stops there.
+*/
+
+typedef struct Scope {
+        const struct Scope* enclosing; // NULL for top-level functions
+        ResolverRecord* locals;
+        uint32_t nb_params;
+        unsigned int level;
+} Scope;
+
+static Node* resolve(parser_info *const state, const Scope* scope, Node* node);
+
+static void collect_locals(const Node* node, ResolverRecord** record) {
+        // nested functions are leaves: their locals belong to them
+        if (node == NULL || node->operator <= LAST_OP_LEAF) return;
+
+        if (node->operator == OP_AFFECT) {
+                char const* key = node->operands[0].nd->token.source;
+                if (lookup_key(*record, key) == UINT32_MAX) *record = add_key(*record, key);
+        }
+
+        const ChildRange children = childRange(node);
+        for (uintptr_t i=children.first; i<children.end; i++) collect_locals(node->operands[i].nd, record);
+}
+static uintptr_t read_addresses(parser_info *const state, const Scope* scope, char const* key, Node *const var) {
+        // counts the addresses, and fills them in if <var> isn't NULL
+        uintptr_t count = 0;
+
+        for (uint32_t depth=0; scope != NULL; scope=scope->enclosing, depth++) {
+                const uint32_t slot = lookup_key(scope->locals, key);
+                if (slot == UINT32_MAX) continue;
+                count++;
+                if (var != NULL) var->operands[count].addr = (Address) {.depth=depth, .slot=slot};
+                if (slot < scope->nb_params) return count;
+        }
+
+        count++;
+        if (var != NULL) var->operands[count].addr = (Address) {.depth=ADDR_GLOBAL, .slot=record_global(state, key)};
+        return count;
+}
+static Node* resolve_read(parser_info *const state, const Scope* scope, Node* var) {
+        const uintptr_t count = read_addresses(state, scope, var->token.source, NULL);
+        Node *const new = allocateNode(state, count+1);
+        *new = (Node) {.token=var->token, .operator=OP_VARIABLE};
+        new->operands[0].len = read_addresses(state, scope, var->token.source, new);
+        return new;
+}
+static Node* resolve_target(parser_info *const state, const Scope* scope, Node* var) {
+        // assignments only ever touch the current frame
+        char const* key = var->token.source;
+        const uint32_t slot = (scope == NULL) ? record_global(state, key) : lookup_key(scope->locals, key);
+
+        if (slot == UINT32_MAX) {
+                // augmented assignment of a non-local; fails at runtime
+                var->operands[0].len = 0;
+                return var;
+        }
+
+        Node *const new = allocateNode(state, 2);
+        *new = (Node) {.token=var->token, .operator=OP_VARIABLE};
+        new->operands[0].len = 1;
+        new->operands[1].addr = (Address) {.depth=(scope == NULL) ? ADDR_GLOBAL : 0, .slot=slot};
+        return new;
+}
+static void resolve_function(parser_info *const state, const Scope* enclosing, ObjFunction *const fun) {
+        Scope scope = {
+                .enclosing=enclosing,
+                .locals=mk_record(),
+                .nb_params=fun->arity,
+                .level=(enclosing == NULL) ? 1 : enclosing->level+1,
+        };
+        for (size_t i=0; i<fun->arity; i++) scope.locals = add_key(scope.locals, fun->arguments[i]);
+        collect_locals(fun->body, &(scope.locals));
+
+        fun->level = scope.level;
+        fun->frame_size = scope.locals->len;
+        fun->body = resolve(state, &scope, fun->body);
+
+        free_record(scope.locals);
+}
+static Node* resolve(parser_info *const state, const Scope* scope, Node* node) {
+        if (node == NULL) return NULL;
+
+        switch (node->operator) {
+                case OP_VARIABLE:
+                        return resolve_read(state, scope, node);
+                case OP_LITERAL_FUNCTION:
+                        resolve_function(state, scope, node->operands[0].obj.funval);
+                        return node;
+                case OP_AFFECT:
+                case OP_IADD:
+                case OP_ISUB:
+                case OP_IMUL:
+                case OP_IDIV:
+                        node->operands[0].nd = resolve_target(state, scope, node->operands[0].nd);
+                        node->operands[1].nd = resolve(state, scope, node->operands[1].nd);
+                        return node;
+                default:
+                        break;
+        }
+
+        const ChildRange children = childRange(node);
+        for (uintptr_t i=children.first; i<children.end; i++) node->operands[i].nd = resolve(state, scope, node->operands[i].nd);
+        return node;
+}
+
+// ------------------ end resolver --------------------------------------------
+
+Node* parse_statement(parser_info *const state) {
+        // top-level statements are complete once parsed, we can resolve them
+        return resolve(state, NULL, _parse_statement(state));
+}
+Node* parse_program(parser_info *const state) {
+        // the whole source as a single block, resolved at once
+        const size_t mark = state->pending_top;
+        const Token token = *peek(state);
+        while (getTtype(state) != TOKEN_EOF) {
+                Node* stmt = _parse_statement(state);
+                if (stmt == NULL) {
+                        state->pending_top = mark;
+                        return NULL;
+                }
+                push_pending(state, stmt);
+        }
+        return resolve(state, NULL, pop_pending(state, mark, token, OP_BLOCK));
+}
+
+
 #undef ALLOCATE_SIMPLE_NODE
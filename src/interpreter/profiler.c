@@ -0,0 +1,225 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "interpreter/profiler.h"
+#include "error.h"
+
+#define INITIAL_CAPACITY 256 // entries, stack levels
+#define SUMMARY_LINES 20
+#define ROOT_NAME "<main>"
+#define ANONYMOUS_NAME "<function>"
+#define NO_OFFSET UINT32_MAX // of a function without a body
+
+typedef struct ProfileEntry {
+        // a node of the tree of call stacks: a function (name != NULL) or a source position
+        uint32_t parent;
+        SourceOffset offset; // turned into a line and a column only in the results
+        const char* name;
+        uint64_t count;
+        uint64_t self_ns;
+} ProfileEntry;
+
+typedef struct ActiveNode {
+        uint64_t start;
+        uint64_t children_ns; // spent in the nodes it evaluated
+        uint32_t frame;
+        SourceOffset offset;
+} ActiveNode;
+
+int profiling = 0;
+
+static struct {
+        ProfileEntry* entries;
+        size_t nb_entries, capacity;
+        uint32_t* index; // open addressing, entry id + 1, 0 for empty
+        size_t index_size;
+
+        uint32_t* frames;
+        size_t nb_frames, frames_capacity;
+        ActiveNode* nodes;
+        size_t nb_nodes, nodes_capacity;
+} profile;
+
+static uint64_t now_ns(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// ------------------------------ entries --------------------------------------
+
+static size_t entry_hash(const uint32_t parent, const char* name, const SourceOffset offset) {
+        uint64_t h = parent;
+        h = h * 0x9E3779B97F4A7C15u ^ (uintptr_t) name;
+        h = h * 0x9E3779B97F4A7C15u ^ offset;
+        return (size_t) (h ^ (h >> 29));
+}
+static void grow_index(void) {
+        free(profile.index);
+        profile.index_size *= 2;
+        profile.index = calloc(profile.index_size, sizeof(profile.index[0]));
+        for (size_t id=0; id<profile.nb_entries; id++) {
+                const ProfileEntry *const e = &(profile.entries[id]);
+                size_t slot = entry_hash(e->parent, e->name, e->offset) & (profile.index_size-1);
+                while (profile.index[slot]) slot = (slot+1) & (profile.index_size-1);
+                profile.index[slot] = id+1;
+        }
+}
+static uint32_t find_entry(const uint32_t parent, const char* name, const SourceOffset offset) {
+        // names are interned or static, comparing pointers is enough
+        size_t slot = entry_hash(parent, name, offset) & (profile.index_size-1);
+        for (uint32_t id; (id = profile.index[slot]); slot = (slot+1) & (profile.index_size-1)) {
+                const ProfileEntry *const e = &(profile.entries[id-1]);
+                if (e->parent == parent && e->name == name && e->offset == offset) return id-1;
+        }
+
+        if (profile.nb_entries == profile.capacity) {
+                profile.capacity *= 2;
+                profile.entries = realloc(profile.entries, profile.capacity*sizeof(profile.entries[0]));
+        }
+        const uint32_t id = profile.nb_entries++;
+        profile.entries[id] = (ProfileEntry) {.parent=parent, .offset=offset, .name=name};
+        profile.index[slot] = id+1;
+        if (2*profile.nb_entries > profile.index_size) grow_index();
+        return id;
+}
+
+// ------------------------------ hooks ----------------------------------------
+
+void start_profiler(void) {
+        profile.capacity = profile.frames_capacity = profile.nodes_capacity = INITIAL_CAPACITY;
+        profile.index_size = 2*INITIAL_CAPACITY;
+        profile.entries = malloc(profile.capacity*sizeof(profile.entries[0]));
+        profile.index = calloc(profile.index_size, sizeof(profile.index[0]));
+        profile.frames = malloc(profile.frames_capacity*sizeof(profile.frames[0]));
+        profile.nodes = malloc(profile.nodes_capacity*sizeof(profile.nodes[0]));
+        profile.nb_entries = profile.nb_nodes = 0;
+
+        profile.frames[0] = find_entry(UINT32_MAX, ROOT_NAME, NO_OFFSET);
+        profile.nb_frames = 1;
+        profiling = 1;
+}
+
+void profile_enter(const Node* node) {
+        if (profile.nb_nodes == profile.nodes_capacity) {
+                profile.nodes_capacity *= 2;
+                profile.nodes = realloc(profile.nodes, profile.nodes_capacity*sizeof(profile.nodes[0]));
+        }
+        profile.nodes[profile.nb_nodes++] = (ActiveNode) {
+                .frame=profile.frames[profile.nb_frames-1],
+                .offset=node->token.offset,
+                .start=now_ns(),
+        };
+}
+void profile_exit(void) {
+        const ActiveNode *const node = &(profile.nodes[--profile.nb_nodes]);
+        const uint64_t elapsed = now_ns() - node->start;
+        const uint32_t id = find_entry(node->frame, NULL, node->offset); // may move the entries
+        ProfileEntry *const entry = &(profile.entries[id]);
+        entry->count++;
+        entry->self_ns += elapsed - node->children_ns;
+        if (profile.nb_nodes) profile.nodes[profile.nb_nodes-1].children_ns += elapsed;
+}
+
+static uint32_t function_entry(const uint32_t parent, const Node* call, const ObjFunction* function) {
+        // functions are known by the variable they are called through, and where their body starts
+        const Node *const callee = call->operands[1].nd;
+        const char *const name = (callee->operator == OP_VARIABLE) ? callee->token.source : ANONYMOUS_NAME;
+        return find_entry(parent, name, (function->body != NULL) ? function->body->token.offset : NO_OFFSET);
+}
+void profile_call(const Node* call, const ObjFunction* function) {
+        if (profile.nb_frames == profile.frames_capacity) {
+                profile.frames_capacity *= 2;
+                profile.frames = realloc(profile.frames, profile.frames_capacity*sizeof(profile.frames[0]));
+        }
+        profile.frames[profile.nb_frames] = function_entry(profile.frames[profile.nb_frames-1], call, function);
+        profile.nb_frames++;
+}
+void profile_tail_call(const Node* call, const ObjFunction* function) {
+        const uint32_t parent = profile.entries[profile.frames[profile.nb_frames-1]].parent;
+        profile.frames[profile.nb_frames-1] = function_entry(parent, call, function);
+}
+void profile_return(void) {
+        profile.nb_frames--;
+}
+
+// ------------------------------ results --------------------------------------
+
+static void write_stack(FILE* file, const uint32_t id) {
+        const ProfileEntry *const entry = &(profile.entries[id]);
+        if (entry->parent != UINT32_MAX) {
+                write_stack(file, entry->parent);
+                fputc(';', file);
+        }
+        const Localization pos = (entry->offset != NO_OFFSET) ? source_position(entry->offset) : (Localization) {.line=0, .column=0};
+        if (entry->name == NULL) fprintf(file, "line %u:%u", pos.line, pos.column);
+        else if (entry->parent == UINT32_MAX) fputs(entry->name, file);
+        else fprintf(file, "%s@%u", entry->name, pos.line);
+}
+static int by_position(const void* a, const void* b) {
+        const ProfileEntry *const ea = a, *const eb = b;
+        return (ea->offset > eb->offset) - (ea->offset < eb->offset);
+}
+static int by_time(const void* a, const void* b) {
+        const ProfileEntry *const ea = a, *const eb = b;
+        return (ea->self_ns < eb->self_ns) - (ea->self_ns > eb->self_ns);
+}
+static void write_summary(FILE* file) {
+        // positions merged across call stacks
+        ProfileEntry *const positions = malloc((profile.nb_entries+1)*sizeof(positions[0]));
+        size_t nb_positions = 0;
+        uint64_t total_ns = 0;
+        for (size_t id=0; id<profile.nb_entries; id++) {
+                if (profile.entries[id].name != NULL) continue;
+                positions[nb_positions++] = profile.entries[id];
+                total_ns += profile.entries[id].self_ns;
+        }
+        qsort(positions, nb_positions, sizeof(positions[0]), by_position);
+        size_t merged = 0;
+        for (size_t i=0; i<nb_positions; i++) {
+                if (merged && !by_position(&(positions[merged-1]), &(positions[i]))) {
+                        positions[merged-1].count += positions[i].count;
+                        positions[merged-1].self_ns += positions[i].self_ns;
+                }
+                else positions[merged++] = positions[i];
+        }
+        qsort(positions, merged, sizeof(positions[0]), by_time);
+
+        fprintf(file, "Profile: %.3f ms in %lu source positions\n", total_ns/1e6, merged);
+        fprintf(file, "%14s %14s %12s %7s\n", "line:column", "count", "self (ms)", "self %");
+        for (size_t i=0; i<merged && i<SUMMARY_LINES; i++) {
+                char position[32];
+                const Localization pos = source_position(positions[i].offset);
+                snprintf(position, sizeof(position), "%u:%u", pos.line, pos.column);
+                fprintf(file, "%14s %14lu %12.3f %6.2f%%\n",
+                        position, positions[i].count, positions[i].self_ns/1e6,
+                        total_ns ? 100.0*positions[i].self_ns/total_ns : 0.0);
+        }
+        free(positions);
+}
+
+void stop_profiler(FILE* folded, FILE* summary) {
+        if (folded != NULL) {
+                for (size_t id=0; id<profile.nb_entries; id++) {
+                        if (profile.entries[id].name != NULL || profile.entries[id].self_ns == 0) continue;
+                        write_stack(folded, id);
+                        fprintf(folded, " %lu\n", profile.entries[id].self_ns);
+                }
+        }
+        if (summary != NULL) write_summary(summary);
+
+        free(profile.entries);
+        free(profile.index);
+        free(profile.frames);
+        free(profile.nodes);
+        profiling = 0;
+}
+
+#undef INITIAL_CAPACITY
+#undef SUMMARY_LINES
+#undef ROOT_NAME
+#undef ANONYMOUS_NAME
+#undef NO_OFFSET
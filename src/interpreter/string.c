@@ -3,40 +3,97 @@
 #include <stddef.h>
 
 #include "interpreter/string.h"
+#include "interpreter/gc.h"
+
+#define ROPE_MIN_LEN 64 // shorter concatenations are copied right away
 
-//TODO: implement a gc
 void free_string(ObjString* container) {
+        if (container->value != container->chars) free(container->value);
         free(container);
 }
 
 static ObjString* allocate_string(const intmax_t len) {
         // allocates an ObjString big enough to contain a string of length <len> (not counting the final '\0').
-        return malloc(offsetof(ObjString, value) + sizeof(char)*(len+1));
+        const size_t size = offsetof(ObjString, chars) + sizeof(char)*(len+1);
+        ObjString *const container = malloc(size);
+        container->len = len;
+        container->left = container->right = NULL;
+        container->value = container->chars;
+        container->value[len] = '\0';
+        gc_track(&(container->gc), GC_STRING, size);
+        return container;
+}
+
+static void flatten_into(const ObjString* str, char* dest) {
+        // Loops into the longer operand, recurses into the shorter one.
+        // Rope nodes are at least ROPE_MIN_LEN long, so the recursion depth is logarithmic.
+        while (str->value == NULL) {
+                const ObjString *const left = str->left;
+                const ObjString *const right = str->right;
+                if (left->len >= right->len) {
+                        flatten_into(right, dest+left->len);
+                        str = left;
+                } else {
+                        flatten_into(left, dest);
+                        dest += left->len;
+                        str = right;
+                }
+        }
+        memcpy(dest, str->value, str->len);
+}
+
+const char* stringValue(ObjString* str) {
+        if (str->value == NULL) {
+                LOG("Flattening a rope of %ld characters", str->len);
+                char *const buffer = malloc(sizeof(char)*(str->len+1));
+                flatten_into(str, buffer);
+                buffer[str->len] = '\0';
+                gc_grow(&(str->gc), sizeof(char)*(str->len+1));
+
+                // the operands may now be collected
+                str->value = buffer;
+                str->left = str->right = NULL;
+        }
+        return str->value;
 }
 
 ObjString* makeString(const char* string, intmax_t len) {
         // WARNING : hidden malloc()
         ObjString *const container = allocate_string(len);
-        container->len = len;
-        strncpy(container->value, string, len); // we need strncpy here cuz the string buffer may not be null-terminated (source code buffer)
+        memcpy(container->value, string, len); // the string buffer may not be null-terminated (source code buffer)
         return container;
 }
 
-ObjString* concatenateStrings(const ObjString* strA, const ObjString* strB) {
+ObjString* concatenateStrings(ObjString* strA, ObjString* strB) {
         // WARNING : hidden malloc()
-        const intmax_t len_total = strA->len + strB->len;
-        ObjString *const container = allocate_string(len_total);
-        container->len = len_total;
-        strcpy(container->value, strA->value);
-        strcpy(container->value+(strA->len), strB->value);
+        if (strA->len == 0) return strB;
+        if (strB->len == 0) return strA;
+
+        const intmax_t len = strA->len + strB->len;
+        if (len < ROPE_MIN_LEN) {
+                ObjString *const container = allocate_string(len);
+                memcpy(container->value, stringValue(strA), strA->len);
+                memcpy(container->value+(strA->len), stringValue(strB), strB->len);
+                return container;
+        }
+
+        const size_t size = offsetof(ObjString, chars);
+        ObjString *const container = malloc(size);
+        container->len = len;
+        container->left = strA;
+        container->right = strB;
+        container->value = NULL;
+        gc_track(&(container->gc), GC_STRING, size);
         return container;
 }
-ObjString* multiplyString(const ObjString* str, intmax_t amount) {
+ObjString* multiplyString(ObjString* str, intmax_t amount) {
         // WARNING : hidden malloc()
-        const intmax_t len_total = str->len*amount;
-        ObjString *const dest = allocate_string(len_total);
+        const char *const value = stringValue(str);
+        ObjString *const dest = allocate_string(str->len*amount);
         for (char* i=dest->value; amount>0; (amount--, i+=str->len)) {
-                strcpy(i, str->value);
+                memcpy(i, value, str->len);
         }
         return dest;
 }
+
+#undef ROPE_MIN_LEN
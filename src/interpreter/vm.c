@@ -0,0 +1,130 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "interpreter/vm.h"
+#include "interpreter/builtins.h"
+#include "interpreter/jit.h"
+#include "error.h"
+#include "keywords.h"
+
+_Thread_local mylang_vm* current_vm = NULL;
+
+static const Keyword keywords[] = {
+        {"true", TOKEN_TRUE},
+        {"false", TOKEN_FALSE},
+        {"none", TOKEN_NONE},
+        {"if", TOKEN_IF},
+        {"else", TOKEN_ELSE},
+        {"while", TOKEN_WHILE},
+        {"function", TOKEN_FUNC},
+        {"return", TOKEN_RETURN},
+
+        {NULL, 0}
+};
+
+// ------------------------------ default I/O ----------------------------------
+
+static void write_stdout(void* userdata, const char* text, size_t len) {
+        fwrite(text, 1, len, stdout);
+}
+static ssize_t read_stdin(void* userdata, char** line, size_t* capacity) {
+        fflush(stdout); // the prompt, and whatever came before, must show up now
+        return getline(line, capacity, stdin);
+}
+static void forward_report(void* userdata, const int is_error, const Token* where, const Localization pos, const char* message) {
+        const mylang_io *const io = &(((mylang_vm*) userdata)->io);
+        char *const near = strndup(where->length ? where->source : "", where->length); // tokens aren't null-terminated
+        io->report(
+                io->userdata,
+                is_error ? MYLANG_REPORT_ERROR : MYLANG_REPORT_WARNING,
+                pos.line, pos.column, near,
+                message
+        );
+        free(near);
+}
+
+// ------------------------------ instances ------------------------------------
+
+static inline void declare_variable(pipeline_state *const pipeline, const char* key, Object value) {
+        char *const name = internalize(&(pipeline->interpinfo.prsinfo.lxinfo.record), key, strlen(key));
+        ns_set_value(
+                &(pipeline->interpinfo.ns),
+                (Address) {.depth=ADDR_GLOBAL, .slot=record_global(&(pipeline->interpinfo.prsinfo), name)},
+                value
+        );
+}
+
+mylang_vm* mk_vm(const mylang_io* io, FILE* file, const int with_input) {
+        mylang_vm *const vm = malloc(sizeof(mylang_vm));
+        if (vm == NULL) return NULL;
+
+        vm->io = (io != NULL) ? *io : (mylang_io) {.userdata=NULL};
+        if (vm->io.write == NULL) vm->io.write = write_stdout;
+        if (vm->io.read_line == NULL) vm->io.read_line = read_stdin;
+        mk_heap(&(vm->heap));
+        vm->compiled_loops = NULL;
+        vm->jit_enabled = 1;
+
+        mylang_vm *const previous = enter_vm(vm);
+        mk_pipeline(&(vm->pipeline), file, keywords);
+
+        declare_variable(&(vm->pipeline), "print", OBJ_NATIVEF(&print_value));
+        declare_variable(&(vm->pipeline), "clock", OBJ_NATIVEF(&native_clock));
+
+        declare_variable(&(vm->pipeline), "str", OBJ_NATIVEF(&tostring));
+        declare_variable(&(vm->pipeline), "bool", OBJ_NATIVEF(&tobool));
+        declare_variable(&(vm->pipeline), "int", OBJ_NATIVEF(&toint));
+        declare_variable(&(vm->pipeline), "float", OBJ_NATIVEF(&tofloat));
+
+        if (with_input) declare_variable(&(vm->pipeline), "input", OBJ_NATIVEF(&input));
+        leave_vm(previous);
+
+        return vm;
+}
+void del_vm(mylang_vm* vm) {
+        mylang_vm *const previous = enter_vm(vm);
+        del_pipeline(&(vm->pipeline));
+        leave_vm(previous == vm ? NULL : previous);
+        free(vm);
+}
+
+mylang_vm* enter_vm(mylang_vm* vm) {
+        mylang_vm *const previous = current_vm;
+        current_vm = vm;
+        set_error_source(&(vm->pipeline.interpinfo.prsinfo.lxinfo));
+        if (vm->io.report != NULL) set_reporter((Reporter) {.report=forward_report, .userdata=vm});
+        else set_reporter((Reporter) {.report=NULL});
+        return previous;
+}
+void leave_vm(mylang_vm* previous) {
+        if (previous != NULL) enter_vm(previous);
+        else {
+                current_vm = NULL;
+                set_reporter((Reporter) {.report=NULL});
+                set_error_source(NULL);
+        }
+}
+
+// ------------------------------ public API -----------------------------------
+
+mylang_vm* mylang_new(const mylang_io* io) {
+        return mk_vm(io, NULL, 1);
+}
+void mylang_free(mylang_vm* vm) {
+        del_vm(vm);
+}
+
+void mylang_set_jit(mylang_vm* vm, int enabled) {
+        vm->jit_enabled = enabled;
+}
+
+mylang_status mylang_run(mylang_vm* vm, const char* source, size_t len) {
+        mylang_vm *const previous = enter_vm(vm);
+        restart_lexer(&(vm->pipeline.interpinfo.prsinfo.lxinfo), source, len);
+        restart_parser(&(vm->pipeline.interpinfo.prsinfo));
+        const errcode status = interpretProgram(&(vm->pipeline.interpinfo), NULL);
+        leave_vm(previous);
+
+        return (status == ERROR_ABORT) ? MYLANG_ERROR : MYLANG_OK;
+}
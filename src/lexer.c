@@ -1,128 +1,297 @@
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "lexer.h"
 #include "identifiers_record.h"
 #include "error.h"
 #include "keywords.h"
 
+#define CHUNK_SIZE 4096 // bytes, to start reading a file of unknown size
+#define SCAN_PADDING 16 // NULs after the source, so that a 16-byte load from up to its end stays in the chunk
+
+typedef struct SourceChunk {
+        struct SourceChunk* previous;
+        SourceOffset start; // offset of text[0]
+        unsigned int length;
+        char new_source; // lines count from 1 again, after restart_lexer
+        char text[]; // followed by SCAN_PADDING NULs
+} SourceChunk;
+
+typedef struct LineStart {
+        SourceOffset offset;
+        unsigned int line;
+} LineStart;
+
+static const char no_source[SCAN_PADDING] = {0};
+
+// ------------------------------ keywords -------------------------------------
+
+static inline size_t keyword_slot(const hash_t seed, const hash_t hash) {
+        return (hash * seed) >> (8*sizeof(hash_t) - KEYWORD_BITS);
+}
+
+static void mk_keyword_table(KeywordTable *const table, const Keyword* keywords) {
+        // tries multipliers until the keywords all land in different slots
+        for (hash_t attempt=1; ; attempt++) {
+                memset(table->slots, 0, sizeof(table->slots));
+                table->seed = (hash_t) (0x9E3779B97F4A7C15u * attempt) | 1;
+
+                int perfect = 1;
+                for (size_t i=0; perfect && keywords[i].source != NULL; i++) {
+                        const unsigned int length = strlen(keywords[i].source);
+                        const size_t slot = keyword_slot(table->seed, hash_stringn(keywords[i].source, length));
+                        if (table->slots[slot].source != NULL) perfect = 0;
+                        else {
+                                table->slots[slot].source = keywords[i].source;
+                                table->slots[slot].length = length;
+                                table->slots[slot].type = keywords[i].type;
+                        }
+                }
+                if (perfect) return;
+        }
+}
+
+static inline void detect_keywords(const lexer_info *const lxinfo, Token *const token, const hash_t hash) {
+        // <hash> is that of the token; empty slots have a length of 0, that no identifier has
+        const size_t slot = keyword_slot(lxinfo->keywords.seed, hash);
+        if (
+                lxinfo->keywords.slots[slot].length == token->length &&
+                !memcmp(token->source, lxinfo->keywords.slots[slot].source, token->length)
+        ) {
+                token->type = lxinfo->keywords.slots[slot].type;
+        }
+}
+
+// ------------------------------ lexer ----------------------------------------
+
 void mk_lexer_info(lexer_info *const lxinfo, FILE* file, const Keyword* keywords) {
         lxinfo->file = file;
-        lxinfo->keywords = keywords;
-        lxinfo->pos.line = 1;
-        lxinfo->pos.column = 1;
+        mk_keyword_table(&(lxinfo->keywords), keywords);
+        lxinfo->chunks = NULL;
+        lxinfo->cursor = lxinfo->end = no_source;
+        lxinfo->lines = NULL;
+        lxinfo->nb_lines = lxinfo->lines_capacity = 0;
+        lxinfo->indexed = 0;
+        lxinfo->first_ahead = lxinfo->nb_ahead = 0;
 
-        lxinfo->record = allocateRecord();
+        mk_identifiers_record(&(lxinfo->record));
+        set_error_source(lxinfo);
 }
 void del_lexer_info(lexer_info *const lxinfo) {
-        freeRecord(lxinfo->record);
+        while (lxinfo->chunks != NULL) {
+                SourceChunk *const previous = lxinfo->chunks->previous;
+                free(lxinfo->chunks);
+                lxinfo->chunks = previous;
+        }
+        free(lxinfo->lines);
+        del_identifiers_record(&(lxinfo->record));
+        drop_error_source(lxinfo);
 }
 
 /*
 Note on the content of the token (source) :
-Its value is allocated through malloc() in _lex, then the "ownership" is
-transferred to the static record in intern_token => internalize.
-Therefore, internalize needn't `strndup` it, but it should `free` it if it
-deduplicates it.
+It points into the chunk of source it was lexed from, and isn't
+null-terminated. Identifiers are the exception: their source is the copy
+interned in the record, null-terminated, and unique, so that they can be
+compared by address.
 */
 
-static inline void intern_token(lexer_info *const lxinfo, Token *const token) {
-        if (token->length)
-        token->source = internalize(&(lxinfo->record), token->source, token->length);
+// ------------------------------ source ---------------------------------------
+
+static inline SourceOffset source_offset(const lexer_info *const lxinfo, const char* p) {
+        // <p> is in the current chunk
+        return (lxinfo->chunks != NULL) ? lxinfo->chunks->start + (p - lxinfo->chunks->text) : 0;
+}
+static inline SourceOffset source_end(const lexer_info *const lxinfo) {
+        return source_offset(lxinfo, lxinfo->end);
+}
+
+static void push_chunk(lexer_info *const lxinfo, SourceChunk *const chunk, const size_t len, const SourceOffset start) {
+        memset(chunk->text+len, 0, SCAN_PADDING);
+        chunk->start = start;
+        chunk->length = len;
+        chunk->new_source = (lxinfo->chunks == NULL);
+        chunk->previous = lxinfo->chunks;
+        lxinfo->chunks = chunk;
+        lxinfo->cursor = chunk->text;
+        lxinfo->end = chunk->text + len;
 }
 
-static inline void detect_keywords(const lexer_info *const lxinfo, Token *const token) {
-        for (unsigned int i=0; lxinfo->keywords[i].source != NULL; i++) {
-                if (
-                        strlen(lxinfo->keywords[i].source) == token->length &&
-                        !strncmp(token->source, lxinfo->keywords[i].source, token->length)
-                ) {
-                        token->type = lxinfo->keywords[i].type;
-                        break;
+void restart_lexer(lexer_info *const lxinfo, const char* source, const size_t len) {
+        SourceChunk *const chunk = malloc(offsetof(SourceChunk, text) + len + SCAN_PADDING);
+        memcpy(chunk->text, source, len);
+        push_chunk(lxinfo, chunk, len, source_end(lxinfo));
+        chunk->new_source = 1;
+        lxinfo->file = NULL;
+        lxinfo->nb_ahead = 0; // lexed from the previous source
+}
+
+static int refill(lexer_info *const lxinfo, const char* keep) {
+        // reads more source into a new chunk, that starts with the text from <keep> to the end of the current one
+        FILE *const file = lxinfo->file;
+        if (file == NULL || feof(file)) return 0;
+
+        const size_t kept = lxinfo->end - keep;
+        size_t capacity = kept + CHUNK_SIZE;
+        struct stat st;
+        // only regular files are read whole: a terminal, a pipe or a socket may be fed as the statements run
+        const int whole = (fstat(fileno(file), &st) == 0 && S_ISREG(st.st_mode));
+        if (whole) {
+                const long offset = ftell(file);
+                if (offset >= 0 && st.st_size > offset) capacity = kept + (st.st_size - offset);
+        }
+
+        SourceChunk* chunk = malloc(offsetof(SourceChunk, text) + capacity + SCAN_PADDING);
+        memcpy(chunk->text, keep, kept);
+        size_t len = kept;
+        if (!whole) {
+                // a line at a time, so that statements run as they arrive
+                int c;
+                while ((c = getc(file)) != EOF) {
+                        if (len == capacity) {
+                                capacity *= 2;
+                                chunk = realloc(chunk, offsetof(SourceChunk, text) + capacity + SCAN_PADDING);
+                        }
+                        chunk->text[len++] = c;
+                        if (c == '\n') break;
+                }
+        }
+        else for (size_t got; (got = fread(chunk->text+len, 1, capacity-len, file)) > 0; ) {
+                len += got;
+                if (len == capacity) {
+                        capacity *= 2;
+                        chunk = realloc(chunk, offsetof(SourceChunk, text) + capacity + SCAN_PADDING);
                 }
         }
 
+        if (len == kept) {
+                free(chunk);
+                return 0;
+        }
+        push_chunk(lxinfo, chunk, len, source_offset(lxinfo, keep));
+        return 1;
 }
 
-struct token_buffer {
-        char* source;
-        size_t bufsize;
-        size_t taken;
-};
-static void commit(struct token_buffer *const buffer, char c) {
-        if (buffer->taken >= buffer->bufsize) {
-                buffer->bufsize = buffer->bufsize ? (buffer->bufsize*2) : 1;
-                buffer->source = reallocarray(buffer->source, buffer->bufsize, sizeof(char));
+// ------------------------------ scanning -------------------------------------
+
+/*
+Runs of chars of a class, 16 at a time with SSE2. A run stops at the first
+char out of its class at the latest, and the NUL after the source belongs to
+no class: the loads never go further than the padding of the chunk.
+*/
+
+#ifdef __SSE2__
+
+static inline __m128i in_range(const __m128i chars, const char low, const char high) {
+        // unsigned comparison, from the signed one of SSE2: the range is moved to the bottom of the signed chars
+        const __m128i moved = _mm_add_epi8(chars, _mm_set1_epi8((char) (0x80 - low)));
+        return _mm_cmplt_epi8(moved, _mm_set1_epi8((char) (high - low + 1 - 0x80)));
+}
+static inline unsigned int identifier_mask(const __m128i chars) {
+        const __m128i letters = in_range(_mm_or_si128(chars, _mm_set1_epi8(0x20)), 'a', 'z'); // lowercase or uppercase
+        const __m128i digits = in_range(chars, '0', '9');
+        const __m128i underscores = _mm_cmpeq_epi8(chars, _mm_set1_epi8('_'));
+        return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letters, digits), underscores));
+}
+static inline const char* skip_identifier(const char* p) {
+        for (;; p+=16) {
+                const unsigned int others = ~identifier_mask(_mm_loadu_si128((const __m128i*) p)) & 0xFFFF;
+                if (others) return p + __builtin_ctz(others);
         }
-        buffer->source[buffer->taken++] = c;
 }
-static char pull_char(lexer_info *const state) {
-        const char c = getc(state->file);
-        if (c == '\n') {
-                state->pos.line++;
-                state->pos.column = 1;
-        } else {
-                state->pos.column++;
+static inline const char* skip_digits(const char* p) {
+        for (;; p+=16) {
+                const unsigned int others = ~_mm_movemask_epi8(in_range(_mm_loadu_si128((const __m128i*) p), '0', '9')) & 0xFFFF;
+                if (others) return p + __builtin_ctz(others);
         }
-        return c;
 }
-static char peek(lexer_info *const state) {
-        char c = getc(state->file);
-        ungetc(c, state->file);
-        return c;
+static inline const char* skip_blanks(const char* p) {
+        for (;; p+=16) {
+                const __m128i chars = _mm_loadu_si128((const __m128i*) p);
+                const unsigned int blanks = _mm_movemask_epi8(_mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\t'))),
+                        _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\r')))
+                ));
+                const unsigned int others = ~blanks & 0xFFFF;
+                if (others) return p + __builtin_ctz(others);
+        }
+}
+static inline const char* find_quote(const char* p, const char* end) {
+        // returns <end> if there is none
+        for (;; p+=16) {
+                unsigned int quotes = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) p), _mm_set1_epi8('"')));
+                if (end - p < 16) quotes &= (1u << (end - p)) - 1;
+                if (quotes) return p + __builtin_ctz(quotes);
+                if (end - p <= 16) return end;
+        }
 }
 
-Token _lex(lexer_info *const state) {
-        #define PEEK() (peek(state))
-        #define COMMIT(c) (commit(&buffer, c))
-        #define EQUAL_FOLLOWS(then_, else_) (\
-                COMMIT(staging),\
-                (PEEK() == '=')?\
-                (\
-                        COMMIT(pull_char(state)),\
-                        then_\
-                ):\
-                else_\
-        )
-        #define REQUIRES(chr, ttype) (\
-                COMMIT(staging),\
-                (PEEK() == chr)?\
-                (\
-                        COMMIT(staging),\
-                        COMMIT(pull_char(state)), \
-                        ttype\
-                ):\
-                TOKEN_ERROR\
-        )
+#else
+
+#define ISDIGIT(c) (c >= '0' && c <= '9')
+#define ISLETTER(c) (\
+        (c >= 'a' && c <= 'z')\
+        || (c >= 'A' && c <= 'Z')\
+)
+
+static inline const char* skip_identifier(const char* p) {
+        while (*p == '_' || ISLETTER(*p) || ISDIGIT(*p)) p++;
+        return p;
+}
+static inline const char* skip_digits(const char* p) {
+        while (ISDIGIT(*p)) p++;
+        return p;
+}
+static inline const char* skip_blanks(const char* p) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+        return p;
+}
+static inline const char* find_quote(const char* p, const char* end) {
+        const char *const quote = memchr(p, '"', end - p);
+        return (quote != NULL) ? quote : end;
+}
+
+#undef ISDIGIT
+#undef ISLETTER
+
+#endif
+
+// ------------------------------ tokens ---------------------------------------
+
+static int _lex(lexer_info *const state, Token *const token, hash_t *const hash, const int may_read) {
+        // returns 0, and leaves the cursor on the token, if the token may go on in source not read yet and <may_read> is 0
+        #define EQUAL_FOLLOWS(then_, else_) ((*p == '=') ? (p++, then_) : else_)
+        #define REQUIRES(chr, ttype) ((*p == chr) ? (p++, ttype) : TOKEN_ERROR)
 
         #define ISDIGIT(c) (c >= '0' && c <= '9')
         #define ISLETTER(c) (\
                 (c >= 'a' && c <= 'z')\
                 || (c >= 'A' && c <= 'Z')\
         )
-        #define ISBLANK(c) (\
-                c == '\n'\
-                || c == '\t'\
-                || c == '\r'\
-                || c == ' '\
-        )
 
         Token target;
-        struct token_buffer buffer = (struct token_buffer) {.source = malloc(0), .bufsize=0, .taken=0};
-        char staging;
+        const char* start;
+        const char* p;
 
-        while (ISBLANK(PEEK())) pull_char(state);
+        do state->cursor = skip_blanks(state->cursor);
+        while (state->cursor == state->end && may_read && refill(state, state->end));
 
+again:
+        start = state->cursor;
+        p = start + 1;
 
-        switch(staging = pull_char(state)) {
-                case EOF: target.type = TOKEN_EOF; break;
-
-                case '(': COMMIT(staging); target.type = TOKEN_POPEN; break;
-                case ')': COMMIT(staging); target.type = TOKEN_PCLOSE; break;
-                case ';': COMMIT(staging); target.type = TOKEN_SEMICOLON; break;
-                case ',': COMMIT(staging); target.type = TOKEN_COMMA; break;
-                case '{': COMMIT(staging); target.type = TOKEN_BOPEN; break;
-                case '}': COMMIT(staging); target.type = TOKEN_BCLOSE; break;
+        switch(*start) {
+                case '(': target.type = TOKEN_POPEN; break;
+                case ')': target.type = TOKEN_PCLOSE; break;
+                case ';': target.type = TOKEN_SEMICOLON; break;
+                case ',': target.type = TOKEN_COMMA; break;
+                case '{': target.type = TOKEN_BOPEN; break;
+                case '}': target.type = TOKEN_BCLOSE; break;
 
                 case '+':
                         target.type = EQUAL_FOLLOWS(TOKEN_IADD, TOKEN_PLUS);
@@ -157,80 +326,159 @@ Token _lex(lexer_info *const state) {
                         target.type = REQUIRES('|', TOKEN_OR);
                         break;
 
+                case '"':
+                        p = find_quote(p, state->end);
+                        if (p < state->end) {
+                                p++;
+                                target.type = TOKEN_STR;
+                        }
+                        else target.type = TOKEN_ERROR;
+                        break;
+
                 default:
-                        if (ISDIGIT(staging)) {
-                                COMMIT(staging);
+                        if (start == state->end) {
+                                p = start;
+                                target.type = TOKEN_EOF;
+                        }
+                        else if (ISDIGIT(*start)) {
                                 target.type = TOKEN_INT;
-                                while (ISDIGIT(PEEK())) {
-                                        COMMIT(pull_char(state));
-                                }
-                                if (PEEK() == '.') {
-                                        COMMIT(pull_char(state));
+                                p = skip_digits(p);
+                                if (*p == '.') {
                                         target.type = TOKEN_FLOAT;
-                                        while (ISDIGIT(PEEK())) {
-                                                COMMIT(pull_char(state));
-                                        }
+                                        p = skip_digits(p+1);
                                 }
-                                break;
                         }
-                        else if (staging == '_' || ISLETTER(staging)) {
-                                COMMIT(staging);
+                        else if (*start == '_' || ISLETTER(*start)) {
+                                // hashed while it is still in cache, for the record
                                 target.type = TOKEN_IDENTIFIER;
-                                while (staging = PEEK(),
-                                        staging == '_' || ISLETTER(staging) || ISDIGIT(staging)
-                                ) {
-                                        COMMIT(pull_char(state));
-                                }
-                                break;
-                        }
-                        else if (staging == '"') {
-                                COMMIT(staging);
-                                target.type = TOKEN_STR;
-                                while (staging = PEEK(),
-                                        staging != '"' && staging != EOF
-                                ) {
-                                        COMMIT(pull_char(state));
-                                }
-                                if (staging == '"') COMMIT(pull_char(state));
-                                else target.type = TOKEN_ERROR;
-                                break;
-                        }
-                        else {
-                                COMMIT(staging);
-                                target.type = TOKEN_ERROR;
+                                p = skip_identifier(p);
+                                *hash = hash_stringn(start, p - start);
                         }
+                        else target.type = TOKEN_ERROR;
                         break;
         }
 
-        target.length = buffer.taken;
-        target.source = buffer.source;
+        // a token that reaches the end of the chunk may go on in the source that comes next
+        if (p == state->end) {
+                if (!may_read) return 0;
+                if (target.type != TOKEN_EOF && refill(state, start)) goto again;
+        }
 
-        return target;
+        state->cursor = p;
+        target.source = (char*) start;
+        target.offset = source_offset(state, start);
+        if (p - start > MAX_TOKEN_LENGTH) {
+                target.type = TOKEN_ERROR;
+                target.length = MAX_TOKEN_LENGTH;
+        }
+        else target.length = p - start;
+        *token = target;
+        return 1;
 
-        #undef PEEK
-        #undef COMMIT
         #undef EQUAL_FOLLOWS
         #undef REQUIRES
         #undef ISDIGIT
         #undef ISLETTER
-        #undef ISBLANK
 }
 
-LocalizedToken lex(lexer_info *const state) {
-        LocalizedToken ltk;
-        ltk.pos = state->pos; // careful: position first, token second
-        ltk.tok = _lex(state);
-        while (ltk.tok.type == TOKEN_ERROR) {
-                Error(&(ltk), "SyntaxError: unrecognized character.\n");
-                ltk.pos = state->pos;
-                ltk.tok = _lex(state);
+static inline void finish_token(lexer_info *const state, Token *const token, const hash_t hash) {
+        if (token->type == TOKEN_IDENTIFIER) {
+                detect_keywords(state, token, hash);
+                if (token->type == TOKEN_IDENTIFIER) {
+                        token->source = internalize_hashed(&(state->record), token->source, token->length, hash);
+                }
         }
-        intern_token(state, &(ltk.tok));
-        if (ltk.tok.type == TOKEN_IDENTIFIER) {
-                detect_keywords(state, &(ltk.tok));
+
+        LOG("Producing type-%.2d token: `%.*s`. (byte %u)", token->type, token->length, token->source, token->offset);
+}
+
+Token lex(lexer_info *const state) {
+        Token token;
+        hash_t hash;
+        _lex(state, &token, &hash, 1);
+        while (token.type == TOKEN_ERROR) {
+                Error(&token, (token.length == MAX_TOKEN_LENGTH) ? "SyntaxError: token too long.\n" : "SyntaxError: unrecognized character.\n");
+                _lex(state, &token, &hash, 1);
         }
+        finish_token(state, &token, hash);
+        return token;
+}
 
-        LOG("Producing type-%.2d token: `%.*s`. (line %u[%u:%u])", ltk.tok.type, ltk.tok.length, ltk.tok.source, ltk.pos.line, ltk.pos.column, ltk.pos.column+ltk.tok.length-1);
+static int lex_ready(lexer_info *const state, Token *const token) {
+        // lexes the next token only if it needs no more source, and no error report
+        hash_t hash;
+        if (!_lex(state, token, &hash, 0)) return 0;
+        if (token->type == TOKEN_ERROR) {
+                state->cursor = token->source; // lex() will report it, when it comes to it
+                return 0;
+        }
+        finish_token(state, token, hash);
+        return 1;
+}
 
-        return ltk;
+void lex_ahead(lexer_info *const lxinfo, const unsigned int count) {
+        /*
+        The first token is lexed as the parser would have, reading more source and
+        reporting errors as needed; then as many as possible, from the source
+        already read. A terminal is not read further than the parser asked.
+        */
+        while (lxinfo->nb_ahead < count) {
+                lxinfo->ahead[(lxinfo->first_ahead + lxinfo->nb_ahead++) & (LOOKAHEAD-1)] = lex(lxinfo);
+                while (
+                        lxinfo->nb_ahead < LOOKAHEAD
+                        && lex_ready(lxinfo, &(lxinfo->ahead[(lxinfo->first_ahead + lxinfo->nb_ahead) & (LOOKAHEAD-1)]))
+                ) lxinfo->nb_ahead++;
+        }
 }
+
+// ------------------------------ locations ------------------------------------
+
+static void add_line(lexer_info *const lxinfo, const SourceOffset offset, const unsigned int line) {
+        if (lxinfo->nb_lines == lxinfo->lines_capacity) {
+                lxinfo->lines_capacity = lxinfo->lines_capacity ? 2*lxinfo->lines_capacity : 64;
+                lxinfo->lines = realloc(lxinfo->lines, lxinfo->lines_capacity*sizeof(LineStart));
+        }
+        lxinfo->lines[lxinfo->nb_lines++] = (LineStart) {.offset=offset, .line=line};
+}
+
+static void index_lines(lexer_info *const lxinfo) {
+        // the chunks read since the last time, oldest first; an empty source has no line of its own
+        size_t nb_chunks = 0;
+        for (const SourceChunk* c=lxinfo->chunks; c != NULL && c->start + c->length > lxinfo->indexed; c=c->previous) nb_chunks++;
+        const SourceChunk** chunks = malloc(nb_chunks*sizeof(SourceChunk*));
+        const SourceChunk* c = lxinfo->chunks;
+        for (size_t i=nb_chunks; i-->0; c=c->previous) chunks[i] = c;
+
+        for (size_t i=0; i<nb_chunks; i++) {
+                // a chunk starts with the end of the previous one, that may be indexed already
+                const SourceChunk *const chunk = chunks[i];
+                if (chunk->new_source && chunk->start >= lxinfo->indexed) add_line(lxinfo, chunk->start, 1);
+                const char* p = chunk->text + ((lxinfo->indexed > chunk->start) ? lxinfo->indexed - chunk->start : 0);
+                const char *const end = chunk->text + chunk->length;
+                while ((p = memchr(p, '\n', end - p)) != NULL) {
+                        p++;
+                        add_line(lxinfo, chunk->start + (p - chunk->text), lxinfo->lines[lxinfo->nb_lines-1].line + 1);
+                }
+                lxinfo->indexed = chunk->start + chunk->length;
+        }
+        free(chunks);
+}
+
+Localization locate(lexer_info *const lxinfo, const SourceOffset offset) {
+        // the source of a program loaded from the cache is only read now
+        while (offset > source_end(lxinfo) && refill(lxinfo, lxinfo->cursor));
+        if (lxinfo->indexed < source_end(lxinfo)) index_lines(lxinfo);
+
+        if (lxinfo->nb_lines == 0) return (Localization) {.line=1, .column=offset+1}; // no source, or an empty one
+        // the last line that starts at or before <offset>
+        size_t low = 0, high = lxinfo->nb_lines;
+        while (high - low > 1) {
+                const size_t middle = low + (high - low)/2;
+                if (lxinfo->lines[middle].offset <= offset) low = middle;
+                else high = middle;
+        }
+        return (Localization) {.line=lxinfo->lines[low].line, .column=offset - lxinfo->lines[low].offset + 1};
+}
+
+#undef CHUNK_SIZE
+#undef SCAN_PADDING